@@ -0,0 +1,77 @@
+#include "bench-common.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+namespace socow_bench {
+namespace {
+
+template <typename T>
+std::vector<T> decode(size_t size) {
+  std::vector<T> result;
+  result.reserve(size);
+  for (size_t i = 0; i < size; ++i) {
+    result.push_back(make_value<T>(i));
+  }
+  return result;
+}
+
+template <typename T>
+void ingest_push_back(benchmark::State& state) {
+  for (auto _ : state) {
+    std::vector<T> decoded = decode<T>(state.range(0));
+    socow_vector<T, 16> message;
+    message.reserve(decoded.size());
+    for (const T& value : decoded) {
+      message.push_back(value);
+    }
+    benchmark::DoNotOptimize(std::as_const(message).data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename T>
+void ingest_from_std_vector(benchmark::State& state) {
+  for (auto _ : state) {
+    auto message = socow_vector<T, 16>::from_std_vector(decode<T>(state.range(0)));
+    benchmark::DoNotOptimize(std::as_const(message).data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void export_copy(benchmark::State& state) {
+  for (auto _ : state) {
+    state.PauseTiming();
+    auto body = make_container<socow_vector<char, 16>>(state.range(0));
+    state.ResumeTiming();
+    auto* buffer = static_cast<char*>(std::malloc(body.size()));
+    std::memcpy(buffer, std::as_const(body).data(), body.size());
+    benchmark::DoNotOptimize(buffer);
+    std::free(buffer);
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+void export_release(benchmark::State& state) {
+  for (auto _ : state) {
+    state.PauseTiming();
+    auto body = make_container<socow_vector<char, 16>>(state.range(0));
+    state.ResumeTiming();
+    auto buffer = body.release();
+    benchmark::DoNotOptimize(buffer.data);
+    buffer.deallocate(buffer.context, buffer.size);
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(ingest_push_back<int>)->Apply(container_sizes);
+BENCHMARK(ingest_from_std_vector<int>)->Apply(container_sizes);
+BENCHMARK(ingest_push_back<std::string>)->Apply(container_sizes);
+BENCHMARK(ingest_from_std_vector<std::string>)->Apply(container_sizes);
+BENCHMARK(export_copy)->Range(1 << 12, 1 << 24)->Iterations(32);
+BENCHMARK(export_release)->Range(1 << 12, 1 << 24)->Iterations(32);
+
+} // namespace
+} // namespace socow_bench
@@ -0,0 +1,54 @@
+#include "bench-common.h"
+
+#include "socow-appender.h"
+
+#include <mutex>
+#include <optional>
+
+namespace socow_bench {
+namespace {
+
+using results = socow_vector<int64_t, 4>;
+
+results appended;
+std::optional<socow_concurrent_appender<int64_t, 4>> appender;
+
+std::mutex guarded_mutex;
+results guarded;
+
+void append_concurrent(benchmark::State& state) {
+  if (state.thread_index() == 0) {
+    appended = results();
+    appender.emplace(appended);
+  }
+  int64_t value = state.thread_index();
+  for (auto _ : state) {
+    appender->push_back(value++);
+  }
+  if (state.thread_index() == 0) {
+    appender.reset();
+    benchmark::DoNotOptimize(appended.size());
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+void append_mutex(benchmark::State& state) {
+  if (state.thread_index() == 0) {
+    guarded = results();
+  }
+  int64_t value = state.thread_index();
+  for (auto _ : state) {
+    std::lock_guard lock(guarded_mutex);
+    guarded.push_back(value++);
+  }
+  if (state.thread_index() == 0) {
+    benchmark::DoNotOptimize(guarded.size());
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(append_concurrent)->ThreadRange(1, 64)->UseRealTime();
+BENCHMARK(append_mutex)->ThreadRange(1, 64)->UseRealTime();
+
+} // namespace
+} // namespace socow_bench
@@ -0,0 +1,73 @@
+#include "bench-common.h"
+
+#include "socow-atomic.h"
+
+#include <mutex>
+
+namespace socow_bench {
+namespace {
+
+using table = socow_vector<int, 4>;
+
+constexpr size_t TABLE_SIZE = 4096;
+constexpr int64_t UPDATE_PERIOD = 4096;
+
+atomic_socow_vector<int, 4> published(make_container<table>(TABLE_SIZE));
+
+std::mutex guarded_mutex;
+table guarded = make_container<table>(TABLE_SIZE);
+
+void snapshot_atomic(benchmark::State& state) {
+  int64_t reads = 0;
+  for (auto _ : state) {
+    table snapshot = published.load();
+    benchmark::DoNotOptimize(std::as_const(snapshot)[reads % TABLE_SIZE]);
+    if (state.thread_index() == 0 && ++reads % UPDATE_PERIOD == 0) {
+      published.update([&](table& value) { value[0] = static_cast<int>(reads); });
+    }
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+#if SOCOW_VECTOR_EPOCH_RECLAMATION
+void borrow_epoch(benchmark::State& state) {
+  int64_t reads = 0;
+  for (auto _ : state) {
+    {
+      socow_epoch_guard guard;
+      benchmark::DoNotOptimize(published.borrow(guard)[reads % TABLE_SIZE]);
+    }
+    if (state.thread_index() == 0 && ++reads % UPDATE_PERIOD == 0) {
+      published.update([&](table& value) { value[0] = static_cast<int>(reads); });
+    }
+  }
+  socow_epoch_reclaim();
+  state.SetItemsProcessed(state.iterations());
+}
+#endif
+
+void snapshot_mutex(benchmark::State& state) {
+  int64_t reads = 0;
+  for (auto _ : state) {
+    table snapshot;
+    {
+      std::lock_guard lock(guarded_mutex);
+      snapshot = guarded;
+    }
+    benchmark::DoNotOptimize(std::as_const(snapshot)[reads % TABLE_SIZE]);
+    if (state.thread_index() == 0 && ++reads % UPDATE_PERIOD == 0) {
+      std::lock_guard lock(guarded_mutex);
+      guarded[0] = static_cast<int>(reads);
+    }
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(snapshot_atomic)->ThreadRange(1, 64)->UseRealTime();
+#if SOCOW_VECTOR_EPOCH_RECLAMATION
+BENCHMARK(borrow_epoch)->ThreadRange(1, 64)->UseRealTime();
+#endif
+BENCHMARK(snapshot_mutex)->ThreadRange(1, 64)->UseRealTime();
+
+} // namespace
+} // namespace socow_bench
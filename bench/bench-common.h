@@ -0,0 +1,106 @@
+#pragma once
+
+#include "socow-vector.h"
+
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#if SOCOW_BENCH_HAVE_BOOST
+#include <boost/container/small_vector.hpp>
+#endif
+
+#if SOCOW_BENCH_HAVE_ABSL
+#include <absl/container/inlined_vector.h>
+#endif
+
+namespace socow_bench {
+
+struct pod64 {
+  char bytes[64];
+};
+
+template <typename T>
+T make_value(size_t index) {
+  if constexpr (std::is_same_v<T, pod64>) {
+    pod64 result;
+    std::memset(result.bytes, static_cast<int>(index), sizeof(result.bytes));
+    return result;
+  } else if constexpr (std::is_same_v<T, std::string>) {
+    return "element number " + std::to_string(index) + " outside of SSO";
+  } else {
+    return static_cast<T>(index);
+  }
+}
+
+template <typename Container>
+Container make_container(size_t size) {
+  Container result;
+  for (size_t i = 0; i < size; ++i) {
+    result.push_back(make_value<typename Container::value_type>(i));
+  }
+  return result;
+}
+
+template <typename T>
+const char* type_name() {
+  if constexpr (std::is_same_v<T, pod64>) {
+    return "pod64";
+  } else if constexpr (std::is_same_v<T, std::string>) {
+    return "string";
+  } else if constexpr (std::is_same_v<T, int>) {
+    return "int";
+  } else if constexpr (std::is_same_v<T, char>) {
+    return "char";
+  } else if constexpr (std::is_same_v<T, float>) {
+    return "float";
+  } else {
+    return "T";
+  }
+}
+
+inline void container_sizes(benchmark::internal::Benchmark* bench) {
+  for (int size : {4, 16, 256, 4096}) {
+    bench->Arg(size);
+  }
+}
+
+template <typename T>
+struct container_names {
+  static std::string socow(size_t small_size) {
+    return "socow_vector<" + std::string(type_name<T>()) + "," + std::to_string(small_size) + ">";
+  }
+
+  static std::string std_vector() {
+    return "std::vector<" + std::string(type_name<T>()) + ">";
+  }
+
+  static std::string boost_small_vector(size_t small_size) {
+    return "boost::small_vector<" + std::string(type_name<T>()) + "," + std::to_string(small_size) + ">";
+  }
+
+  static std::string absl_inlined_vector(size_t small_size) {
+    return "absl::InlinedVector<" + std::string(type_name<T>()) + "," + std::to_string(small_size) + ">";
+  }
+};
+
+template <template <typename> class Suite, typename T>
+void register_containers() {
+  using names = container_names<T>;
+  Suite<socow_vector<T, 4>>::add(names::socow(4));
+  Suite<socow_vector<T, 16>>::add(names::socow(16));
+  Suite<std::vector<T>>::add(names::std_vector());
+#if SOCOW_BENCH_HAVE_BOOST
+  Suite<boost::container::small_vector<T, 4>>::add(names::boost_small_vector(4));
+  Suite<boost::container::small_vector<T, 16>>::add(names::boost_small_vector(16));
+#endif
+#if SOCOW_BENCH_HAVE_ABSL
+  Suite<absl::InlinedVector<T, 4>>::add(names::absl_inlined_vector(4));
+  Suite<absl::InlinedVector<T, 16>>::add(names::absl_inlined_vector(16));
+#endif
+}
+
+} // namespace socow_bench
@@ -0,0 +1,168 @@
+#include "socow-vector.h"
+
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <utility>
+
+namespace {
+
+struct operation_counts {
+  size_t copies = 0;
+  size_t moves = 0;
+  size_t destructions = 0;
+};
+
+thread_local operation_counts counts;
+
+struct element {
+  size_t value;
+
+  element(size_t value = 0) noexcept : value(value) {}
+
+  element(const element& other) noexcept : value(other.value) {
+    ++counts.copies;
+  }
+
+  element(element&& other) noexcept : value(other.value) {
+    ++counts.moves;
+  }
+
+  element& operator=(const element& other) noexcept {
+    ++counts.copies;
+    value = other.value;
+    return *this;
+  }
+
+  element& operator=(element&& other) noexcept {
+    ++counts.moves;
+    value = other.value;
+    return *this;
+  }
+
+  ~element() {
+    ++counts.destructions;
+  }
+};
+
+constexpr size_t SMALL_SIZE = 4;
+using vector = socow_vector<element, SMALL_SIZE>;
+
+vector make_vector(size_t size) {
+  vector result;
+  result.reserve(size);
+  for (size_t i = 0; i < size; ++i) {
+    result.push_back(element(i));
+  }
+  return result;
+}
+
+template <typename Setup, typename Operation>
+void measure(benchmark::State& state, Setup setup, Operation operation) {
+  operation_counts total;
+  size_t allocations = 0;
+  for (auto _ : state) {
+    state.PauseTiming();
+    auto fixture = setup();
+    counts = {};
+    socow_stats::reset_thread_stats();
+    state.ResumeTiming();
+    operation(fixture);
+    state.PauseTiming();
+    allocations += socow_stats::thread_stats().allocations;
+    total.copies += counts.copies;
+    total.moves += counts.moves;
+    total.destructions += counts.destructions;
+    state.ResumeTiming();
+  }
+  auto per_iteration = [&](size_t value) {
+    return benchmark::Counter(static_cast<double>(value), benchmark::Counter::kAvgIterations);
+  };
+  state.counters["allocations"] = per_iteration(allocations);
+  state.counters["copies"] = per_iteration(total.copies);
+  state.counters["moves"] = per_iteration(total.moves);
+  state.counters["destructions"] = per_iteration(total.destructions);
+}
+
+void copy_shared(benchmark::State& state) {
+  measure(state, [&] { return make_vector(state.range(0)); },
+          [](vector& source) { benchmark::DoNotOptimize(vector(source).size()); });
+}
+
+void const_access_shared(benchmark::State& state) {
+  measure(state, [&] { return std::pair(make_vector(state.range(0)), vector()); },
+          [](auto& fixture) {
+            fixture.second = fixture.first;
+            benchmark::DoNotOptimize(&std::as_const(fixture.second)[0]);
+            benchmark::DoNotOptimize(std::as_const(fixture.second).begin());
+          });
+}
+
+void first_write_shared(benchmark::State& state) {
+  measure(state, [&] { return std::pair(make_vector(state.range(0)), vector()); },
+          [](auto& fixture) {
+            fixture.second = fixture.first;
+            fixture.second[0] = element(7);
+          });
+}
+
+void write_unique(benchmark::State& state) {
+  measure(state, [&] { return make_vector(state.range(0)); }, [](vector& v) { v[0] = element(7); });
+}
+
+void push_back_full(benchmark::State& state) {
+  measure(state, [&] {
+    vector result = make_vector(state.range(0));
+    result.shrink_to_fit();
+    return result;
+  }, [](vector& v) { v.push_back(element(7)); });
+}
+
+void push_back_reserved(benchmark::State& state) {
+  measure(state, [] { return vector(); },
+          [&](vector& v) {
+            v.reserve(state.range(0));
+            for (int64_t i = 0; i < state.range(0); ++i) {
+              v.push_back(element(i));
+            }
+          });
+}
+
+void insert_middle(benchmark::State& state) {
+  measure(state, [&] {
+    vector result = make_vector(state.range(0));
+    result.reserve(state.range(0) + 1);
+    return result;
+  }, [](vector& v) { v.insert(std::as_const(v).begin() + v.size() / 2, element(7)); });
+}
+
+void erase_middle(benchmark::State& state) {
+  measure(state, [&] { return make_vector(state.range(0)); },
+          [](vector& v) { v.erase(std::as_const(v).begin() + v.size() / 2); });
+}
+
+void swap(benchmark::State& state) {
+  measure(state, [&] { return std::pair(make_vector(state.range(0)), make_vector(state.range(0) / 2)); },
+          [](auto& fixture) { fixture.first.swap(fixture.second); });
+}
+
+void clear_unique(benchmark::State& state) {
+  measure(state, [&] { return make_vector(state.range(0)); }, [](vector& v) { v.clear(); });
+}
+
+void sizes(benchmark::internal::Benchmark* bench) {
+  bench->Arg(SMALL_SIZE - 1)->Arg(SMALL_SIZE * 4)->Arg(1024);
+}
+
+BENCHMARK(copy_shared)->Apply(sizes);
+BENCHMARK(const_access_shared)->Apply(sizes);
+BENCHMARK(first_write_shared)->Apply(sizes);
+BENCHMARK(write_unique)->Apply(sizes);
+BENCHMARK(push_back_full)->Apply(sizes);
+BENCHMARK(push_back_reserved)->Apply(sizes);
+BENCHMARK(insert_middle)->Apply(sizes);
+BENCHMARK(erase_middle)->Apply(sizes);
+BENCHMARK(swap)->Apply(sizes);
+BENCHMARK(clear_unique)->Apply(sizes);
+
+} // namespace
@@ -0,0 +1,121 @@
+#include "bench-common.h"
+
+#include <utility>
+
+namespace socow_bench {
+namespace {
+
+template <typename Container>
+struct container_suite {
+  using value_type = typename Container::value_type;
+
+  static void push_back(benchmark::State& state) {
+    size_t size = state.range(0);
+    value_type value = make_value<value_type>(1);
+    for (auto _ : state) {
+      Container container;
+      for (size_t i = 0; i < size; ++i) {
+        container.push_back(value);
+      }
+      benchmark::DoNotOptimize(container.data());
+    }
+    state.SetItemsProcessed(state.iterations() * size);
+  }
+
+  static void copy(benchmark::State& state) {
+    Container source = make_container<Container>(state.range(0));
+    for (auto _ : state) {
+      Container container(source);
+      benchmark::DoNotOptimize(std::as_const(container).data());
+    }
+  }
+
+  static void first_write(benchmark::State& state) {
+    Container source = make_container<Container>(state.range(0));
+    value_type value = make_value<value_type>(7);
+    for (auto _ : state) {
+      Container container(source);
+      container[0] = value;
+      benchmark::DoNotOptimize(std::as_const(container).data());
+    }
+  }
+
+  static void insert_erase_middle(benchmark::State& state) {
+    Container container = make_container<Container>(state.range(0));
+    value_type value = make_value<value_type>(7);
+    size_t middle = container.size() / 2;
+    for (auto _ : state) {
+      container.insert(std::as_const(container).begin() + middle, value);
+      container.erase(std::as_const(container).begin() + middle);
+      benchmark::DoNotOptimize(std::as_const(container).data());
+    }
+  }
+
+  static void swap(benchmark::State& state) {
+    Container first = make_container<Container>(state.range(0));
+    Container second = make_container<Container>(state.range(0) / 2);
+    for (auto _ : state) {
+      first.swap(second);
+      benchmark::DoNotOptimize(std::as_const(first).data());
+      benchmark::DoNotOptimize(std::as_const(second).data());
+    }
+  }
+
+  static void assign(benchmark::State& state) {
+    Container first = make_container<Container>(state.range(0));
+    Container second = make_container<Container>(state.range(0) / 2);
+    Container target;
+    for (auto _ : state) {
+      target = first;
+      benchmark::DoNotOptimize(std::as_const(target).data());
+      target = second;
+      benchmark::DoNotOptimize(std::as_const(target).data());
+    }
+  }
+
+  static void iterate(benchmark::State& state) {
+    Container container = make_container<Container>(state.range(0));
+    for (auto _ : state) {
+      size_t checksum = 0;
+      for (const value_type& element : std::as_const(container)) {
+        checksum += reinterpret_cast<const unsigned char&>(element);
+      }
+      benchmark::DoNotOptimize(checksum);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+  }
+
+  static void iterate_mutable(benchmark::State& state) {
+    Container container = make_container<Container>(state.range(0));
+    for (auto _ : state) {
+      size_t checksum = 0;
+      for (value_type& element : container) {
+        checksum += reinterpret_cast<unsigned char&>(element);
+      }
+      benchmark::DoNotOptimize(checksum);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+  }
+
+  static void add(const std::string& name) {
+    benchmark::RegisterBenchmark(("push_back/" + name).c_str(), push_back)->Apply(container_sizes);
+    benchmark::RegisterBenchmark(("copy/" + name).c_str(), copy)->Apply(container_sizes);
+    benchmark::RegisterBenchmark(("first_write/" + name).c_str(), first_write)->Apply(container_sizes);
+    benchmark::RegisterBenchmark(("insert_erase_middle/" + name).c_str(), insert_erase_middle)
+        ->Apply(container_sizes);
+    benchmark::RegisterBenchmark(("swap/" + name).c_str(), swap)->Apply(container_sizes);
+    benchmark::RegisterBenchmark(("assign/" + name).c_str(), assign)->Apply(container_sizes);
+    benchmark::RegisterBenchmark(("iterate/" + name).c_str(), iterate)->Apply(container_sizes);
+    benchmark::RegisterBenchmark(("iterate_mutable/" + name).c_str(), iterate_mutable)->Apply(container_sizes);
+  }
+};
+
+const bool registered = [] {
+  register_containers<container_suite, int>();
+  register_containers<container_suite, pod64>();
+  register_containers<container_suite, std::string>();
+  return true;
+}();
+
+} // namespace
+} // namespace socow_bench
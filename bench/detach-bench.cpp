@@ -0,0 +1,100 @@
+#include "bench-common.h"
+
+#include "socow-incremental.h"
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace socow_bench {
+namespace {
+
+template <typename T>
+void first_write_sync(benchmark::State& state) {
+  auto snapshot = make_container<socow_vector<T, 16>>(state.range(0));
+  for (auto _ : state) {
+    state.PauseTiming();
+    auto writer = snapshot;
+    state.ResumeTiming();
+    writer[0] = make_value<T>(1);
+    benchmark::DoNotOptimize(std::as_const(writer).data());
+    state.PauseTiming();
+    writer = {};
+    state.ResumeTiming();
+  }
+}
+
+template <typename T>
+void first_write_prepared(benchmark::State& state) {
+  auto snapshot = make_container<socow_vector<T, 16>>(state.range(0));
+  for (auto _ : state) {
+    state.PauseTiming();
+    auto writer = snapshot;
+    writer.detach_async([](auto task) { task(); });
+    state.ResumeTiming();
+    writer[0] = make_value<T>(1);
+    benchmark::DoNotOptimize(std::as_const(writer).data());
+    state.PauseTiming();
+    writer = {};
+    state.ResumeTiming();
+  }
+}
+
+void record_percentiles(benchmark::State& state, std::vector<double>& latencies) {
+  std::sort(latencies.begin(), latencies.end());
+  auto percentile = [&](double fraction) {
+    return latencies[std::min(latencies.size() - 1, static_cast<size_t>(fraction * latencies.size()))];
+  };
+  state.counters["p50_ns"] = percentile(0.5);
+  state.counters["p99_ns"] = percentile(0.99);
+  state.counters["p999_ns"] = percentile(0.999);
+  state.counters["max_ns"] = latencies.back();
+}
+
+void write_tail_latency(benchmark::State& state) {
+  constexpr size_t SIZE = 10'000'000;
+  constexpr size_t OPERATIONS = 1 << 12;
+  size_t budget = state.range(0);
+  auto snapshot = make_container<socow_vector<int, 16>>(SIZE);
+  std::mt19937_64 random(42);
+  std::vector<double> latencies;
+  latencies.reserve(OPERATIONS * 8);
+  for (auto _ : state) {
+    state.PauseTiming();
+    auto writer = snapshot;
+    state.ResumeTiming();
+    if (budget == 0) {
+      for (size_t i = 0; i < OPERATIONS; ++i) {
+        auto start = std::chrono::steady_clock::now();
+        writer[random() % SIZE] = static_cast<int>(i);
+        latencies.push_back(std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count());
+      }
+    } else {
+      auto start = std::chrono::steady_clock::now();
+      socow_incremental_detach<int, 16> detach(writer, budget);
+      latencies.push_back(std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count());
+      for (size_t i = 1; i < OPERATIONS; ++i) {
+        start = std::chrono::steady_clock::now();
+        detach[random() % SIZE] = static_cast<int>(i);
+        latencies.push_back(std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count());
+      }
+    }
+    benchmark::DoNotOptimize(std::as_const(writer).data());
+    state.PauseTiming();
+    writer = {};
+    state.ResumeTiming();
+  }
+  record_percentiles(state, latencies);
+  state.SetItemsProcessed(state.iterations() * OPERATIONS);
+}
+
+BENCHMARK(first_write_sync<int>)->Range(1 << 10, 1 << 22);
+BENCHMARK(first_write_prepared<int>)->Range(1 << 10, 1 << 22);
+BENCHMARK(first_write_sync<std::string>)->Range(1 << 10, 1 << 18);
+BENCHMARK(first_write_prepared<std::string>)->Range(1 << 10, 1 << 18);
+BENCHMARK(write_tail_latency)->Arg(0)->Arg(1 << 10)->Arg(1 << 12)->Arg(1 << 14)->Iterations(8);
+
+} // namespace
+} // namespace socow_bench
@@ -0,0 +1,67 @@
+#include "bench-common.h"
+
+#include "socow-intern.h"
+
+#include <unordered_set>
+
+namespace socow_bench {
+namespace {
+
+using interned_vector = socow_vector<int, 4>;
+
+constexpr size_t VECTOR_LENGTH = 256;
+constexpr size_t VECTOR_COUNT = 10000;
+
+interned_vector make_duplicate(size_t index, size_t distinct) {
+  interned_vector result;
+  for (size_t i = 0; i < VECTOR_LENGTH; ++i) {
+    result.push_back(static_cast<int>(index % distinct + i));
+  }
+  return result;
+}
+
+size_t heap_bytes(const std::vector<interned_vector>& vectors) {
+  std::unordered_set<const int*> buffers;
+  size_t result = 0;
+  for (const interned_vector& vector : vectors) {
+    if (buffers.insert(vector.data()).second) {
+      result += vector.capacity() * sizeof(int);
+    }
+  }
+  return result;
+}
+
+void build(benchmark::State& state, bool intern) {
+  size_t distinct = state.range(0);
+  size_t bytes = 0;
+  for (auto _ : state) {
+    socow_intern_table<int, 4> table;
+    std::vector<interned_vector> vectors;
+    vectors.reserve(VECTOR_COUNT);
+    for (size_t i = 0; i < VECTOR_COUNT; ++i) {
+      vectors.push_back(make_duplicate(i, distinct));
+      if (intern) {
+        socow_intern(vectors.back(), table);
+      }
+    }
+    state.PauseTiming();
+    bytes = heap_bytes(vectors);
+    state.ResumeTiming();
+  }
+  state.SetItemsProcessed(state.iterations() * VECTOR_COUNT);
+  state.counters["heap_bytes"] = static_cast<double>(bytes);
+}
+
+void build_plain(benchmark::State& state) {
+  build(state, false);
+}
+
+void build_interned(benchmark::State& state) {
+  build(state, true);
+}
+
+BENCHMARK(build_plain)->Arg(10)->Arg(100)->Arg(10000)->Unit(benchmark::kMillisecond);
+BENCHMARK(build_interned)->Arg(10)->Arg(100)->Arg(10000)->Unit(benchmark::kMillisecond);
+
+} // namespace
+} // namespace socow_bench
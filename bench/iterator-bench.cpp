@@ -0,0 +1,56 @@
+#include "bench-common.h"
+
+namespace socow_bench {
+namespace {
+
+using shared_vector = socow_vector<int, 16>;
+
+void read_shared_raw(benchmark::State& state) {
+  const shared_vector source = make_container<shared_vector>(state.range(0));
+  for (auto _ : state) {
+    shared_vector copy = source;
+    int64_t sum = 0;
+    for (int& element : copy) {
+      sum += element;
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void read_shared_cow(benchmark::State& state) {
+  const shared_vector source = make_container<shared_vector>(state.range(0));
+  for (auto _ : state) {
+    shared_vector copy = source;
+    int64_t sum = 0;
+    for (auto&& element : copy.cow_elements()) {
+      sum += element.get();
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void read_shared_const(benchmark::State& state) {
+  const shared_vector source = make_container<shared_vector>(state.range(0));
+  for (auto _ : state) {
+    shared_vector copy = source;
+    int64_t sum = 0;
+    for (const int& element : std::as_const(copy)) {
+      sum += element;
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void iterator_sizes(benchmark::internal::Benchmark* bench) {
+  bench->RangeMultiplier(16)->Range(64, 1 << 20);
+}
+
+BENCHMARK(read_shared_raw)->Apply(iterator_sizes);
+BENCHMARK(read_shared_cow)->Apply(iterator_sizes);
+BENCHMARK(read_shared_const)->Apply(iterator_sizes);
+
+} // namespace
+} // namespace socow_bench
@@ -0,0 +1,65 @@
+#include "bench-common.h"
+
+#include "socow-parallel.h"
+
+#include <thread>
+
+namespace socow_bench {
+namespace {
+
+using samples = socow_vector<float, 16>;
+
+constexpr size_t SAMPLE_COUNT = 100'000'000;
+
+samples& large_vector() {
+  static samples result = [] {
+    samples values;
+    values.reserve(SAMPLE_COUNT);
+    for (size_t i = 0; i < SAMPLE_COUNT; ++i) {
+      values.push_back(static_cast<float>(i % 1024));
+    }
+    return values;
+  }();
+  return result;
+}
+
+void parallel_for_each(benchmark::State& state) {
+  samples& values = large_vector();
+  socow_parallel::pool workers(state.range(0));
+  for (auto _ : state) {
+    socow_parallel::for_each(values, [](float& value) { value = value * 0.5f + 1.0f; }, workers);
+  }
+  state.SetBytesProcessed(state.iterations() * SAMPLE_COUNT * sizeof(float));
+}
+
+void parallel_reduce(benchmark::State& state) {
+  const samples& values = large_vector();
+  socow_parallel::pool workers(state.range(0));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(socow_parallel::reduce(values, 0.0, std::plus<>(), workers));
+  }
+  state.SetBytesProcessed(state.iterations() * SAMPLE_COUNT * sizeof(float));
+}
+
+void parallel_fill(benchmark::State& state) {
+  samples& values = large_vector();
+  socow_parallel::pool workers(state.range(0));
+  for (auto _ : state) {
+    socow_parallel::fill(values, 1.0f, workers);
+  }
+  state.SetBytesProcessed(state.iterations() * SAMPLE_COUNT * sizeof(float));
+}
+
+void thread_counts(benchmark::internal::Benchmark* bench) {
+  for (size_t threads = 1; threads <= std::max(std::thread::hardware_concurrency(), 1u) * 2; threads *= 2) {
+    bench->Arg(threads);
+  }
+  bench->UseRealTime()->Unit(benchmark::kMillisecond);
+}
+
+BENCHMARK(parallel_for_each)->Apply(thread_counts);
+BENCHMARK(parallel_reduce)->Apply(thread_counts);
+BENCHMARK(parallel_fill)->Apply(thread_counts);
+
+} // namespace
+} // namespace socow_bench
@@ -0,0 +1,28 @@
+#include "bench-common.h"
+
+#include <string>
+#include <utility>
+
+namespace socow_bench {
+namespace {
+
+template <typename T>
+void drop_last_copy(benchmark::State& state) {
+  for (auto _ : state) {
+    state.PauseTiming();
+    auto snapshot = make_container<socow_vector<T, 16>>(state.range(0));
+    state.ResumeTiming();
+    snapshot = {};
+    benchmark::DoNotOptimize(std::as_const(snapshot).data());
+  }
+#if SOCOW_VECTOR_ASYNC_RECLAMATION
+  socow_reclaim_drain();
+#endif
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(drop_last_copy<int>)->Range(1 << 12, 1 << 22)->Iterations(32);
+BENCHMARK(drop_last_copy<std::string>)->Range(1 << 12, 1 << 20)->Iterations(32);
+
+} // namespace
+} // namespace socow_bench
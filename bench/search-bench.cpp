@@ -0,0 +1,103 @@
+#include "bench-common.h"
+
+#include <algorithm>
+
+namespace socow_bench {
+namespace {
+
+template <typename T>
+socow_vector<T, 16> make_haystack(size_t size) {
+  socow_vector<T, 16> result;
+  for (size_t i = 0; i < size; ++i) {
+    result.push_back(static_cast<T>(i % 100));
+  }
+  return result;
+}
+
+template <typename T>
+void socow_find(benchmark::State& state) {
+  const auto haystack = make_haystack<T>(state.range(0));
+  T needle = static_cast<T>(101);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(haystack.find(needle));
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0) * sizeof(T));
+}
+
+template <typename T>
+void std_find(benchmark::State& state) {
+  const auto haystack = make_haystack<T>(state.range(0));
+  T needle = static_cast<T>(101);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(std::find(haystack.begin(), haystack.end(), needle));
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0) * sizeof(T));
+}
+
+template <typename T>
+void socow_count(benchmark::State& state) {
+  const auto haystack = make_haystack<T>(state.range(0));
+  T needle = static_cast<T>(42);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(haystack.count(needle));
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0) * sizeof(T));
+}
+
+template <typename T>
+void std_count(benchmark::State& state) {
+  const auto haystack = make_haystack<T>(state.range(0));
+  T needle = static_cast<T>(42);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(std::count(haystack.begin(), haystack.end(), needle));
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0) * sizeof(T));
+}
+
+template <typename T>
+void socow_equal(benchmark::State& state) {
+  const auto first = make_haystack<T>(state.range(0));
+  const auto second = make_haystack<T>(state.range(0));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(first == second);
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0) * sizeof(T));
+}
+
+template <typename T>
+void socow_equal_shared(benchmark::State& state) {
+  const auto first = make_haystack<T>(state.range(0));
+  const auto second = first;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(first == second);
+  }
+}
+
+template <typename T>
+void socow_token_validate(benchmark::State& state) {
+  const auto first = make_haystack<T>(state.range(0));
+  const socow_storage_token cached = first.storage_token();
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(first.storage_token() == cached);
+  }
+}
+
+void search_sizes(benchmark::internal::Benchmark* bench) {
+  bench->RangeMultiplier(16)->Range(16, 1 << 20);
+}
+
+#define SOCOW_SEARCH_BENCH(T)                                                                                          \
+  BENCHMARK_TEMPLATE(socow_find, T)->Apply(search_sizes);                                                              \
+  BENCHMARK_TEMPLATE(std_find, T)->Apply(search_sizes);                                                                \
+  BENCHMARK_TEMPLATE(socow_count, T)->Apply(search_sizes);                                                             \
+  BENCHMARK_TEMPLATE(std_count, T)->Apply(search_sizes);                                                               \
+  BENCHMARK_TEMPLATE(socow_equal, T)->Apply(search_sizes);                                                             \
+  BENCHMARK_TEMPLATE(socow_equal_shared, T)->Apply(search_sizes);                                                      \
+  BENCHMARK_TEMPLATE(socow_token_validate, T)->Apply(search_sizes)
+
+SOCOW_SEARCH_BENCH(char);
+SOCOW_SEARCH_BENCH(int);
+SOCOW_SEARCH_BENCH(float);
+
+} // namespace
+} // namespace socow_bench
@@ -0,0 +1,43 @@
+#include "bench-common.h"
+
+#include <utility>
+
+namespace socow_bench {
+namespace {
+
+using table = socow_vector<int, 4>;
+
+constexpr size_t HEAD_SIZE = 8;
+
+const table shared = make_container<table>(1024);
+
+void head_reads_with_churn(benchmark::State& state) {
+  if (shared.size() < HEAD_SIZE) {
+    state.SkipWithError("shared table is shorter than HEAD_SIZE");
+    return;
+  }
+  const int* head = std::as_const(shared).data();
+  int64_t reads = 0;
+  int64_t copies = 0;
+  for (auto _ : state) {
+    if (state.thread_index() == 0) {
+      table copy(shared);
+      benchmark::DoNotOptimize(std::as_const(copy).data());
+      ++copies;
+    } else {
+      int checksum = 0;
+      for (size_t i = 0; i < HEAD_SIZE; ++i) {
+        checksum += head[i];
+      }
+      benchmark::DoNotOptimize(checksum);
+      ++reads;
+    }
+  }
+  state.counters["reads"] = benchmark::Counter(static_cast<double>(reads), benchmark::Counter::kIsRate);
+  state.counters["copies"] = benchmark::Counter(static_cast<double>(copies), benchmark::Counter::kIsRate);
+}
+
+BENCHMARK(head_reads_with_churn)->ThreadRange(2, 64)->UseRealTime();
+
+} // namespace
+} // namespace socow_bench
@@ -0,0 +1,131 @@
+#include "bench-common.h"
+
+#include "socow-shm.h"
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace socow_bench {
+namespace {
+
+using table = socow_vector<int, 4>;
+
+enum class mode : uint64_t { shm, pipe, stop };
+
+struct message {
+  mode kind;
+  socow_shm_handle handle;
+};
+
+void read_exact(int fd, void* buffer, size_t bytes) {
+  auto* cursor = static_cast<char*>(buffer);
+  while (bytes > 0) {
+    ssize_t done = read(fd, cursor, bytes);
+    if (done <= 0) {
+      _exit(1);
+    }
+    cursor += done;
+    bytes -= done;
+  }
+}
+
+void write_exact(int fd, const void* buffer, size_t bytes) {
+  auto* cursor = static_cast<const char*>(buffer);
+  while (bytes > 0) {
+    ssize_t done = write(fd, cursor, bytes);
+    if (done <= 0) {
+      _exit(1);
+    }
+    cursor += done;
+    bytes -= done;
+  }
+}
+
+int64_t checksum(const table& values) {
+  int64_t result = 0;
+  for (int value : values) {
+    result += value;
+  }
+  return result;
+}
+
+[[noreturn]] void consumer(int segment_fd, int requests, int replies) {
+  socow_shm_segment segment = socow_shm_segment::open(segment_fd);
+  while (true) {
+    message request;
+    read_exact(requests, &request, sizeof(request));
+    int64_t result = 0;
+    if (request.kind == mode::stop) {
+      _exit(0);
+    } else if (request.kind == mode::shm) {
+      result = checksum(segment.adopt<int, 4>(request.handle));
+    } else {
+      std::vector<int> buffer(request.handle.size);
+      read_exact(requests, buffer.data(), buffer.size() * sizeof(int));
+      table received;
+      received.reserve(buffer.size());
+      for (int value : buffer) {
+        received.push_back(value);
+      }
+      result = checksum(received);
+    }
+    write_exact(replies, &result, sizeof(result));
+  }
+}
+
+void handoff(benchmark::State& state, mode kind) {
+  size_t size = state.range(0);
+  socow_shm_segment segment = socow_shm_segment::create(size * sizeof(int) * 4 + (1 << 20));
+  table produced = segment.copy(make_container<table>(size));
+
+  int requests[2];
+  int replies[2];
+  if (pipe(requests) != 0 || pipe(replies) != 0) {
+    state.SkipWithError("pipe failed");
+    return;
+  }
+  pid_t child = fork();
+  if (child == 0) {
+    consumer(segment.fd(), requests[0], replies[1]);
+  }
+
+  for (auto _ : state) {
+    message request{kind, {0, size}};
+    if (kind == mode::shm) {
+      request.handle = segment.share(produced);
+      write_exact(requests[1], &request, sizeof(request));
+    } else {
+      write_exact(requests[1], &request, sizeof(request));
+      write_exact(requests[1], std::as_const(produced).data(), size * sizeof(int));
+    }
+    int64_t result;
+    read_exact(replies[0], &result, sizeof(result));
+    benchmark::DoNotOptimize(result);
+  }
+  state.SetBytesProcessed(state.iterations() * size * sizeof(int));
+
+  message stop{mode::stop, {0, 0}};
+  write_exact(requests[1], &stop, sizeof(stop));
+  waitpid(child, nullptr, 0);
+  for (int fd : {requests[0], requests[1], replies[0], replies[1]}) {
+    close(fd);
+  }
+}
+
+void handoff_shm(benchmark::State& state) {
+  handoff(state, mode::shm);
+}
+
+void handoff_pipe(benchmark::State& state) {
+  handoff(state, mode::pipe);
+}
+
+BENCHMARK(handoff_shm)->Range(1 << 10, 1 << 20)->UseRealTime();
+BENCHMARK(handoff_pipe)->Range(1 << 10, 1 << 20)->UseRealTime();
+
+} // namespace
+} // namespace socow_bench
@@ -0,0 +1,56 @@
+#include "bench-common.h"
+
+#include "socow-mmap.h"
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <utility>
+
+namespace socow_bench {
+namespace {
+
+using table = socow_vector<int, 4>;
+
+std::string snapshot_path(size_t size) {
+  return "socow-snapshot-bench-" + std::to_string(size) + ".bin";
+}
+
+void load_mmap(benchmark::State& state) {
+  size_t size = state.range(0);
+  std::string path = snapshot_path(size);
+  socow_save(path, make_container<table>(size));
+  for (auto _ : state) {
+    table loaded = socow_load<int, 4>(path);
+    benchmark::DoNotOptimize(std::as_const(loaded)[size / 2]);
+  }
+  state.SetBytesProcessed(state.iterations() * size * sizeof(int));
+  std::remove(path.c_str());
+}
+
+void load_push_back(benchmark::State& state) {
+  size_t size = state.range(0);
+  std::string path = snapshot_path(size);
+  {
+    table source = make_container<table>(size);
+    std::ofstream out(path, std::ios::binary);
+    out.write(reinterpret_cast<const char*>(std::as_const(source).data()), size * sizeof(int));
+  }
+  for (auto _ : state) {
+    std::ifstream in(path, std::ios::binary);
+    table loaded;
+    int value;
+    while (in.read(reinterpret_cast<char*>(&value), sizeof(value))) {
+      loaded.push_back(value);
+    }
+    benchmark::DoNotOptimize(std::as_const(loaded)[size / 2]);
+  }
+  state.SetBytesProcessed(state.iterations() * size * sizeof(int));
+  std::remove(path.c_str());
+}
+
+BENCHMARK(load_mmap)->Range(1 << 10, 1 << 24);
+BENCHMARK(load_push_back)->Range(1 << 10, 1 << 24);
+
+} // namespace
+} // namespace socow_bench
@@ -0,0 +1,104 @@
+#pragma once
+
+#include "socow-vector.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+template <typename T, size_t SMALL_SIZE, size_t ALIGNMENT = alignof(T)>
+class socow_concurrent_appender {
+public:
+  using vector_type = socow_vector<T, SMALL_SIZE, ALIGNMENT>;
+
+  explicit socow_concurrent_appender(vector_type& vector, size_t expected = 0) : _vector(vector) {
+    _vector.reserve(std::max(_vector.size() + expected, SMALL_SIZE + 1));
+    _buffer = _vector.data();
+    _capacity.store(_vector.capacity(), std::memory_order_relaxed);
+    _tail.store(_vector.size(), std::memory_order_relaxed);
+    _committed.store(_vector.size(), std::memory_order_relaxed);
+  }
+
+  socow_concurrent_appender(const socow_concurrent_appender&) = delete;
+  socow_concurrent_appender& operator=(const socow_concurrent_appender&) = delete;
+
+  ~socow_concurrent_appender() {
+    publish();
+  }
+
+  template <typename... Args>
+  void emplace_back(Args&&... args) {
+    static_assert(std::is_nothrow_constructible_v<T, Args&&...>,
+                  "a claimed slot must always be committed, so construction cannot throw");
+    size_t index = _tail.fetch_add(1, std::memory_order_relaxed);
+    if (index >= _capacity.load(std::memory_order_acquire)) {
+      wait_for_slot(index);
+    }
+    new (_buffer + index) T(std::forward<Args>(args)...);
+    _committed.fetch_add(1, std::memory_order_release);
+  }
+
+  void push_back(const T& value) {
+    emplace_back(value);
+  }
+
+  void push_back(T&& value) {
+    emplace_back(std::move(value));
+  }
+
+  void publish() noexcept {
+    size_t size = _tail.load(std::memory_order_acquire);
+    if (_failed.load(std::memory_order_acquire)) {
+      size = std::min(size, _capacity.load(std::memory_order_acquire));
+    }
+    while (_committed.load(std::memory_order_acquire) != size) {
+      std::this_thread::yield();
+    }
+    socow_detail::storage_access::commit_size(_vector, size);
+    _buffer = _vector.data();
+  }
+
+private:
+  void wait_for_slot(size_t index) {
+    while (true) {
+      size_t capacity = _capacity.load(std::memory_order_acquire);
+      if (index < capacity) {
+        return;
+      }
+      if (_failed.load(std::memory_order_acquire)) {
+        throw std::bad_alloc();
+      }
+      if (index == capacity) {
+        grow(capacity);
+      } else {
+        std::this_thread::yield();
+      }
+    }
+  }
+
+  void grow(size_t capacity) {
+    while (_committed.load(std::memory_order_acquire) != capacity) {
+      std::this_thread::yield();
+    }
+    socow_detail::storage_access::commit_size(_vector, capacity);
+    try {
+      _vector.reserve(capacity * 2);
+    } catch (...) {
+      _failed.store(true, std::memory_order_release);
+      throw;
+    }
+    _buffer = _vector.data();
+    _capacity.store(_vector.capacity(), std::memory_order_release);
+  }
+
+  vector_type& _vector;
+  T* _buffer;
+  alignas(64) std::atomic<size_t> _tail;
+  alignas(64) std::atomic<size_t> _committed;
+  alignas(64) std::atomic<size_t> _capacity;
+  std::atomic<bool> _failed{false};
+};
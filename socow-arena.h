@@ -0,0 +1,175 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <unordered_map>
+
+namespace socow_detail {
+
+class alignas(64) shared_arena {
+public:
+  static constexpr uint64_t MAGIC = 0x31766f636f736f73;
+  static constexpr size_t BLOCK_ALIGNMENT = 64;
+
+  static shared_arena* create(void* base, size_t bytes) noexcept {
+    if (bytes < sizeof(shared_arena)) {
+      return nullptr;
+    }
+    auto* arena = new (base) shared_arena(bytes);
+    return arena;
+  }
+
+  static shared_arena* attach(void* base, size_t bytes) noexcept {
+    auto* arena = static_cast<shared_arena*>(base);
+    if (bytes < sizeof(shared_arena) || arena->_magic != MAGIC || arena->_size != bytes) {
+      return nullptr;
+    }
+    return arena;
+  }
+
+  shared_arena(const shared_arena&) = delete;
+  shared_arena& operator=(const shared_arena&) = delete;
+
+  void* allocate(size_t bytes) noexcept {
+    size_t needed = round_up(bytes) + BLOCK_ALIGNMENT;
+    lock();
+    size_t* link = &_free;
+    while (*link != 0) {
+      block* candidate = block_at(*link);
+      if (candidate->size >= needed) {
+        size_t offset = *link;
+        *link = candidate->next;
+        unlock();
+        return payload_of(offset);
+      }
+      link = &candidate->next;
+    }
+    if (_size - _top < needed) {
+      unlock();
+      return nullptr;
+    }
+    size_t offset = _top;
+    _top += needed;
+    block_at(offset)->size = needed;
+    unlock();
+    return payload_of(offset);
+  }
+
+  void deallocate(void* pointer) noexcept {
+    size_t offset = offset_of(pointer) - BLOCK_ALIGNMENT;
+    lock();
+    block_at(offset)->next = _free;
+    _free = offset;
+    unlock();
+  }
+
+  bool contains(const void* pointer) const noexcept {
+    auto address = reinterpret_cast<uintptr_t>(pointer);
+    auto base = reinterpret_cast<uintptr_t>(this);
+    return address >= base + sizeof(shared_arena) && address < base + _size;
+  }
+
+  size_t offset_of(const void* pointer) const noexcept {
+    return reinterpret_cast<const char*>(pointer) - reinterpret_cast<const char*>(this);
+  }
+
+  void* at(size_t offset) noexcept {
+    return reinterpret_cast<char*>(this) + offset;
+  }
+
+private:
+  struct block {
+    size_t size;
+    size_t next;
+  };
+
+  explicit shared_arena(size_t bytes) noexcept : _magic(MAGIC), _size(bytes), _top(sizeof(shared_arena)) {}
+
+  static size_t round_up(size_t bytes) noexcept {
+    return (bytes + BLOCK_ALIGNMENT - 1) / BLOCK_ALIGNMENT * BLOCK_ALIGNMENT;
+  }
+
+  block* block_at(size_t offset) noexcept {
+    return static_cast<block*>(at(offset));
+  }
+
+  void* payload_of(size_t offset) noexcept {
+    return at(offset + BLOCK_ALIGNMENT);
+  }
+
+  void lock() noexcept {
+    while (_lock.exchange(true, std::memory_order_acquire)) {
+      while (_lock.load(std::memory_order_relaxed)) {
+        std::this_thread::yield();
+      }
+    }
+  }
+
+  void unlock() noexcept {
+    _lock.store(false, std::memory_order_release);
+  }
+
+  uint64_t _magic;
+  size_t _size;
+  std::atomic<bool> _lock{false};
+  size_t _top;
+  size_t _free = 0;
+};
+
+class arena_mappings {
+public:
+  using unmapper = void (*)(void* base, size_t bytes) noexcept;
+
+  static void map(void* base, size_t bytes, unmapper unmap) {
+    arena_mappings& self = instance();
+    std::lock_guard lock(self._mutex);
+    self._mappings.emplace(base, mapping{1, bytes, unmap});
+  }
+
+  static void retain(const void* base) noexcept {
+    arena_mappings& self = instance();
+    std::lock_guard lock(self._mutex);
+    auto it = self._mappings.find(base);
+    if (it != self._mappings.end()) {
+      ++it->second.references;
+    }
+  }
+
+  static void release(const void* base) noexcept {
+    mapping released;
+    {
+      arena_mappings& self = instance();
+      std::lock_guard lock(self._mutex);
+      auto it = self._mappings.find(base);
+      if (it == self._mappings.end() || --it->second.references != 0) {
+        return;
+      }
+      released = it->second;
+      self._mappings.erase(it);
+    }
+    released.unmap(const_cast<void*>(base), released.bytes);
+  }
+
+private:
+  struct mapping {
+    size_t references;
+    size_t bytes;
+    unmapper unmap;
+  };
+
+  arena_mappings() = default;
+
+  static arena_mappings& instance() noexcept {
+    static auto* result = new arena_mappings();
+    return *result;
+  }
+
+  std::mutex _mutex;
+  std::unordered_map<const void*, mapping> _mappings;
+};
+
+} // namespace socow_detail
@@ -0,0 +1,183 @@
+#pragma once
+
+#include "socow-vector.h"
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace socow_detail {
+
+class hazard_domain {
+public:
+  struct alignas(64) record {
+    std::atomic<const void*> pointer{nullptr};
+    std::atomic<bool> active{false};
+    record* next = nullptr;
+  };
+
+  static hazard_domain& instance() {
+    static hazard_domain result;
+    return result;
+  }
+
+  hazard_domain(const hazard_domain&) = delete;
+  hazard_domain& operator=(const hazard_domain&) = delete;
+
+  ~hazard_domain() {
+    record* current = _head.load(std::memory_order_acquire);
+    while (current != nullptr) {
+      record* next = current->next;
+      delete current;
+      current = next;
+    }
+  }
+
+  record& local_record() {
+    thread_local record_owner owner(*this);
+    return *owner.owned;
+  }
+
+  bool is_protected(const void* pointer) const noexcept {
+    for (record* current = _head.load(std::memory_order_acquire); current != nullptr; current = current->next) {
+      if (current->pointer.load(std::memory_order_seq_cst) == pointer) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+private:
+  struct record_owner {
+    record* owned;
+
+    explicit record_owner(hazard_domain& domain) : owned(domain.acquire_record()) {}
+
+    ~record_owner() {
+      owned->pointer.store(nullptr, std::memory_order_release);
+      owned->active.store(false, std::memory_order_release);
+    }
+  };
+
+  hazard_domain() = default;
+
+  record* acquire_record() {
+    for (record* current = _head.load(std::memory_order_acquire); current != nullptr; current = current->next) {
+      bool expected = false;
+      if (!current->active.load(std::memory_order_relaxed) &&
+          current->active.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+        return current;
+      }
+    }
+    auto* fresh = new record;
+    fresh->active.store(true, std::memory_order_relaxed);
+    fresh->next = _head.load(std::memory_order_relaxed);
+    while (!_head.compare_exchange_weak(fresh->next, fresh, std::memory_order_release, std::memory_order_relaxed)) {
+    }
+    return fresh;
+  }
+
+  std::atomic<record*> _head{nullptr};
+};
+
+} // namespace socow_detail
+
+template <typename T, size_t SMALL_SIZE, size_t ALIGNMENT = alignof(T)>
+class atomic_socow_vector {
+public:
+  using value_type = socow_vector<T, SMALL_SIZE, ALIGNMENT>;
+
+  atomic_socow_vector() : _current(new value_type()) {}
+
+  explicit atomic_socow_vector(const value_type& value) : _current(new value_type(value)) {}
+
+  atomic_socow_vector(const atomic_socow_vector&) = delete;
+  atomic_socow_vector& operator=(const atomic_socow_vector&) = delete;
+
+  ~atomic_socow_vector() {
+    delete _current.load(std::memory_order_relaxed);
+    for (value_type* retired : _retired) {
+      delete retired;
+    }
+  }
+
+#if SOCOW_VECTOR_EPOCH_RECLAMATION
+  value_type load() const {
+    socow_epoch_guard guard;
+    return *_current.load(std::memory_order_acquire);
+  }
+
+  std::span<const T> borrow(const socow_epoch_guard&) const noexcept {
+    const value_type& current = *_current.load(std::memory_order_acquire);
+    return {current.data(), current.size()};
+  }
+#else
+  value_type load() const {
+    auto& hazard = socow_detail::hazard_domain::instance().local_record();
+    value_type* current = _current.load(std::memory_order_acquire);
+    while (true) {
+      hazard.pointer.store(current, std::memory_order_seq_cst);
+      value_type* validated = _current.load(std::memory_order_seq_cst);
+      if (validated == current) {
+        break;
+      }
+      current = validated;
+    }
+    value_type result(*current);
+    hazard.pointer.store(nullptr, std::memory_order_release);
+    return result;
+  }
+#endif
+
+  void store(const value_type& value) {
+    auto fresh = std::make_unique<value_type>(value);
+    std::lock_guard lock(_writer_mutex);
+    publish(std::move(fresh));
+  }
+
+  template <typename F>
+  void update(F modify) {
+    std::lock_guard lock(_writer_mutex);
+    auto fresh = std::make_unique<value_type>(*_current.load(std::memory_order_relaxed));
+    modify(*fresh);
+    publish(std::move(fresh));
+  }
+
+private:
+#if SOCOW_VECTOR_EPOCH_RECLAMATION
+  void publish(std::unique_ptr<value_type> fresh) {
+    value_type* previous = _current.exchange(fresh.release(), std::memory_order_seq_cst);
+    socow_detail::epoch_domain::instance().retire(previous, 0, sizeof(value_type), &destroy_node);
+  }
+
+  static void destroy_node(void* pointer, size_t) noexcept {
+    delete static_cast<value_type*>(pointer);
+  }
+#else
+  void publish(std::unique_ptr<value_type> fresh) {
+    _retired.reserve(_retired.size() + 1);
+    value_type* previous = _current.exchange(fresh.release(), std::memory_order_seq_cst);
+    _retired.push_back(previous);
+    reclaim();
+  }
+
+  void reclaim() {
+    auto& domain = socow_detail::hazard_domain::instance();
+    std::erase_if(_retired, [&](value_type* retired) {
+      if (domain.is_protected(retired)) {
+        return false;
+      }
+      delete retired;
+      return true;
+    });
+  }
+#endif
+
+  std::atomic<value_type*> _current;
+  std::mutex _writer_mutex;
+  std::vector<value_type*> _retired;
+};
@@ -0,0 +1,239 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#ifndef SOCOW_VECTOR_EPOCH_RECLAMATION
+#define SOCOW_VECTOR_EPOCH_RECLAMATION 0
+#endif
+
+#ifndef SOCOW_VECTOR_EPOCH_RECLAIM_COUNT
+#define SOCOW_VECTOR_EPOCH_RECLAIM_COUNT 64
+#endif
+
+#ifndef SOCOW_VECTOR_EPOCH_RECLAIM_BYTES
+#define SOCOW_VECTOR_EPOCH_RECLAIM_BYTES (1 << 20)
+#endif
+
+namespace socow_detail {
+
+class epoch_domain {
+public:
+  using deleter = void (*)(void* pointer, size_t length) noexcept;
+
+  static constexpr size_t RECLAIM_COUNT = SOCOW_VECTOR_EPOCH_RECLAIM_COUNT;
+  static constexpr size_t RECLAIM_BYTES = SOCOW_VECTOR_EPOCH_RECLAIM_BYTES;
+
+  static epoch_domain& instance() {
+    static epoch_domain result;
+    return result;
+  }
+
+  epoch_domain(const epoch_domain&) = delete;
+  epoch_domain& operator=(const epoch_domain&) = delete;
+
+  ~epoch_domain() {
+    _shutting_down.store(true, std::memory_order_release);
+    std::vector<retired> orphans = std::move(_orphans);
+    for (retired& item : orphans) {
+      item.destroy(item.pointer, item.length);
+    }
+    record* current = _head.load(std::memory_order_acquire);
+    while (current != nullptr) {
+      record* next = current->next;
+      delete current;
+      current = next;
+    }
+  }
+
+  void enter() {
+    thread_state& state = local_state();
+    if (state.depth++ != 0) {
+      return;
+    }
+    uint64_t epoch = _epoch.load(std::memory_order_seq_cst);
+    while (true) {
+      state.owned->state.store((epoch << 1) | 1, std::memory_order_seq_cst);
+      uint64_t current = _epoch.load(std::memory_order_seq_cst);
+      if (current == epoch) {
+        break;
+      }
+      epoch = current;
+    }
+  }
+
+  void leave() noexcept {
+    thread_state& state = local_state();
+    if (--state.depth == 0) {
+      state.owned->state.store(0, std::memory_order_release);
+    }
+  }
+
+  void retire(void* pointer, size_t length, size_t bytes, deleter destroy) {
+    if (_shutting_down.load(std::memory_order_acquire)) {
+      destroy(pointer, length);
+      return;
+    }
+    retired item{pointer, length, bytes, destroy, _epoch.load(std::memory_order_seq_cst)};
+    if (thread_state_destroyed()) {
+      std::lock_guard lock(_orphans_mutex);
+      _orphans.push_back(item);
+      return;
+    }
+    thread_state& state = local_state();
+    state.retired_list.push_back(item);
+    state.retired_bytes += bytes;
+    if (state.retired_list.size() >= RECLAIM_COUNT || state.retired_bytes >= RECLAIM_BYTES) {
+      reclaim(state);
+    }
+  }
+
+  void reclaim() {
+    if (!thread_state_destroyed()) {
+      reclaim(local_state());
+    }
+  }
+
+private:
+  struct alignas(64) record {
+    std::atomic<uint64_t> state{0};
+    std::atomic<bool> active{false};
+    record* next = nullptr;
+  };
+
+  struct retired {
+    void* pointer;
+    size_t length;
+    size_t bytes;
+    deleter destroy;
+    uint64_t epoch;
+  };
+
+  struct thread_state {
+    epoch_domain& domain;
+    record* owned;
+    size_t depth = 0;
+    std::vector<retired> retired_list;
+    size_t retired_bytes = 0;
+
+    explicit thread_state(epoch_domain& domain) : domain(domain), owned(domain.acquire_record()) {}
+
+    ~thread_state() {
+      thread_state_destroyed() = true;
+      owned->state.store(0, std::memory_order_release);
+      domain.flush(*this);
+      owned->active.store(false, std::memory_order_release);
+      std::lock_guard lock(domain._orphans_mutex);
+      domain._orphans.insert(domain._orphans.end(), retired_list.begin(), retired_list.end());
+    }
+  };
+
+  epoch_domain() = default;
+
+  static bool& thread_state_destroyed() noexcept {
+    thread_local bool destroyed = false;
+    return destroyed;
+  }
+
+  thread_state& local_state() {
+    thread_local thread_state state(*this);
+    return state;
+  }
+
+  record* acquire_record() {
+    for (record* current = _head.load(std::memory_order_acquire); current != nullptr; current = current->next) {
+      bool expected = false;
+      if (!current->active.load(std::memory_order_relaxed) &&
+          current->active.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+        return current;
+      }
+    }
+    auto* fresh = new record;
+    fresh->active.store(true, std::memory_order_relaxed);
+    fresh->next = _head.load(std::memory_order_relaxed);
+    while (!_head.compare_exchange_weak(fresh->next, fresh, std::memory_order_release, std::memory_order_relaxed)) {
+    }
+    return fresh;
+  }
+
+  uint64_t try_advance() noexcept {
+    uint64_t epoch = _epoch.load(std::memory_order_seq_cst);
+    for (record* current = _head.load(std::memory_order_acquire); current != nullptr; current = current->next) {
+      uint64_t state = current->state.load(std::memory_order_seq_cst);
+      if ((state & 1) != 0 && (state >> 1) != epoch) {
+        return epoch;
+      }
+    }
+    _epoch.compare_exchange_strong(epoch, epoch + 1, std::memory_order_seq_cst);
+    return _epoch.load(std::memory_order_seq_cst);
+  }
+
+  static void take_expired(std::vector<retired>& items, uint64_t epoch, std::vector<retired>& expired) {
+    auto first_expired = std::partition(items.begin(), items.end(),
+                                        [epoch](const retired& item) { return item.epoch + 2 > epoch; });
+    expired.insert(expired.end(), first_expired, items.end());
+    items.erase(first_expired, items.end());
+  }
+
+  void flush(thread_state& state) {
+    uint64_t epoch = _epoch.load(std::memory_order_seq_cst);
+    while (!state.retired_list.empty()) {
+      reclaim(state);
+      uint64_t current = _epoch.load(std::memory_order_seq_cst);
+      if (current == epoch) {
+        return;
+      }
+      epoch = current;
+    }
+  }
+
+  void reclaim(thread_state& state) {
+    uint64_t epoch = try_advance();
+    std::vector<retired> expired;
+    take_expired(state.retired_list, epoch, expired);
+    state.retired_bytes = 0;
+    for (const retired& item : state.retired_list) {
+      state.retired_bytes += item.bytes;
+    }
+    {
+      std::unique_lock lock(_orphans_mutex, std::try_to_lock);
+      if (lock.owns_lock()) {
+        take_expired(_orphans, epoch, expired);
+      }
+    }
+    for (retired& item : expired) {
+      item.destroy(item.pointer, item.length);
+    }
+  }
+
+  std::atomic<uint64_t> _epoch{2};
+  std::atomic<bool> _shutting_down{false};
+  std::atomic<record*> _head{nullptr};
+  std::mutex _orphans_mutex;
+  std::vector<retired> _orphans;
+};
+
+} // namespace socow_detail
+
+class socow_epoch_guard {
+public:
+  socow_epoch_guard() {
+    socow_detail::epoch_domain::instance().enter();
+  }
+
+  socow_epoch_guard(const socow_epoch_guard&) = delete;
+  socow_epoch_guard& operator=(const socow_epoch_guard&) = delete;
+
+  ~socow_epoch_guard() {
+    socow_detail::epoch_domain::instance().leave();
+  }
+};
+
+inline void socow_epoch_reclaim() {
+  socow_detail::epoch_domain::instance().reclaim();
+}
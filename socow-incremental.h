@@ -0,0 +1,165 @@
+#pragma once
+
+#include "socow-vector.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <utility>
+
+template <typename T, size_t SMALL_SIZE, size_t ALIGNMENT = alignof(T)>
+class socow_incremental_detach {
+public:
+  using vector_type = socow_vector<T, SMALL_SIZE, ALIGNMENT>;
+
+  static constexpr size_t DEFAULT_BUDGET = 4096;
+
+  explicit socow_incremental_detach(vector_type& vector,
+                                    size_t budget = DEFAULT_BUDGET SOCOW_TRACE_SITE_TRAILING_PARAMETER)
+      : _vector(vector), _budget(std::max<size_t>(budget, 1)) {
+    if (socow_detail::storage_access::storage(vector) == nullptr || !socow_detail::storage_access::shared(vector)) {
+      return;
+    }
+    _migrated = std::make_unique<uint64_t[]>((vector.size() + 63) / 64);
+    _target = socow_detail::storage_access::allocate<vector_type>(vector.capacity());
+    _elements = _target->elements();
+    _source = std::as_const(vector).data();
+    _source_size = vector.size();
+    _size = vector.size();
+    socow_detail::storage_access::note_detach(vector, SOCOW_TRACE_SITE);
+  }
+
+  socow_incremental_detach(const socow_incremental_detach&) = delete;
+  socow_incremental_detach& operator=(const socow_incremental_detach&) = delete;
+
+  ~socow_incremental_detach() {
+    try {
+      finish();
+    } catch (...) {
+      abandon();
+    }
+  }
+
+  bool migrating() const noexcept {
+    return _target != nullptr;
+  }
+
+  size_t remaining() const noexcept {
+    return migrating() ? _source_size - _cursor : 0;
+  }
+
+  size_t size() const noexcept {
+    return migrating() ? _size : _vector.size();
+  }
+
+  const T& operator[](size_t index) const noexcept {
+    if (!migrating()) {
+      return std::as_const(_vector)[index];
+    }
+    return migrated(index) ? _elements[index] : _source[index];
+  }
+
+  T& operator[](size_t index) {
+    if (!migrating()) {
+      return _vector[index];
+    }
+    T* element = _elements + index;
+    size_t budget = _budget;
+    if (!migrated(index)) {
+      new (element) T(_source[index]);
+      _migrated[index / 64] |= uint64_t(1) << index % 64;
+      socow_stats::detail::on_copy(sizeof(T));
+      --budget;
+    }
+    step(budget);
+    return *element;
+  }
+
+  void push_back(const T& value) {
+    append(value);
+  }
+
+  void push_back(T&& value) {
+    append(std::move(value));
+  }
+
+  void step() {
+    step(_budget);
+  }
+
+  void finish() {
+    step(std::numeric_limits<size_t>::max());
+  }
+
+private:
+  using storage_type = socow_detail::storage_access::storage_type<vector_type>;
+
+  bool migrated(size_t index) const noexcept {
+    return index < _cursor || index >= _source_size || (_migrated[index / 64] >> index % 64 & 1);
+  }
+
+  void step(size_t budget) {
+    if (!migrating()) {
+      return;
+    }
+    size_t copied = 0;
+    try {
+      while (_cursor < _source_size && copied < budget) {
+        if (!migrated(_cursor)) {
+          new (_elements + _cursor) T(_source[_cursor]);
+          ++copied;
+        }
+        ++_cursor;
+      }
+    } catch (...) {
+      socow_stats::detail::on_copy(copied * sizeof(T));
+      throw;
+    }
+    socow_stats::detail::on_copy(copied * sizeof(T));
+    if (_cursor == _source_size) {
+      socow_detail::storage_access::install(_vector, std::exchange(_target, nullptr), _size);
+      _migrated.reset();
+    }
+  }
+
+  template <typename U>
+  void append(U&& value) {
+    if (!migrating()) {
+      _vector.push_back(std::forward<U>(value));
+      return;
+    }
+    if (_size == _target->capacity()) {
+      finish();
+      _vector.push_back(std::forward<U>(value));
+      return;
+    }
+    new (_elements + _size) T(std::forward<U>(value));
+    ++_size;
+    step(_budget - 1);
+  }
+
+  void abandon() noexcept {
+    if (!migrating()) {
+      return;
+    }
+    for (size_t i = 0; i < _size; ++i) {
+      if (migrated(i)) {
+        _elements[i].~T();
+      }
+    }
+    socow_detail::storage_access::deallocate<vector_type>(std::exchange(_target, nullptr));
+    _migrated.reset();
+  }
+
+  vector_type& _vector;
+  size_t _budget;
+  storage_type* _target = nullptr;
+  T* _elements = nullptr;
+  const T* _source = nullptr;
+  size_t _source_size = 0;
+  size_t _size = 0;
+  size_t _cursor = 0;
+  std::unique_ptr<uint64_t[]> _migrated;
+};
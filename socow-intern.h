@@ -0,0 +1,119 @@
+#pragma once
+
+#include "socow-vector.h"
+
+#include <mutex>
+#include <unordered_map>
+
+template <typename T, size_t SMALL_SIZE, size_t ALIGNMENT>
+class socow_intern_table : private socow_detail::storage_registry {
+  using vector_type = socow_vector<T, SMALL_SIZE, ALIGNMENT>;
+  using dynamic_storage = typename vector_type::dynamic_storage;
+
+  struct entry {
+    dynamic_storage* storage;
+    size_t size;
+  };
+
+public:
+  socow_intern_table() = default;
+
+  socow_intern_table(const socow_intern_table&) = delete;
+  socow_intern_table& operator=(const socow_intern_table&) = delete;
+
+  ~socow_intern_table() {
+    std::lock_guard lock(_mutex);
+    for (auto& [storage, hash] : _hashes) {
+      storage->_registry.store(nullptr, std::memory_order_release);
+    }
+  }
+
+  bool intern(vector_type& vector) {
+    if (vector.is_small()) {
+      return false;
+    }
+    dynamic_storage* storage = vector._dynamic_data;
+    if (storage->arena() != nullptr) {
+      return false;
+    }
+    if (storage->_registry.load(std::memory_order_acquire) == this) {
+      return false;
+    }
+
+    size_t hash = vector.hash();
+    dynamic_storage* shared = find_or_register(vector, hash);
+    if (shared == nullptr) {
+      return false;
+    }
+    vector.dec_references();
+    vector._dynamic_data = shared;
+    return true;
+  }
+
+  size_t size() const {
+    std::lock_guard lock(_mutex);
+    return _hashes.size();
+  }
+
+private:
+  dynamic_storage* find_or_register(const vector_type& vector, size_t hash) {
+    std::lock_guard lock(_mutex);
+    auto [first, last] = _entries.equal_range(hash);
+    for (auto it = first; it != last; ++it) {
+      const entry& candidate = it->second;
+      if (candidate.storage != vector._dynamic_data && candidate.size == vector.size() &&
+          std::equal(candidate.storage->elements(), candidate.storage->elements() + candidate.size, vector.data()) &&
+          candidate.storage->try_inc_references()) {
+        return candidate.storage;
+      }
+    }
+
+    dynamic_storage* storage = vector._dynamic_data;
+    if (storage->_registry.load(std::memory_order_acquire) != nullptr) {
+      return nullptr;
+    }
+    _hashes.emplace(storage, hash);
+    try {
+      _entries.emplace(hash, entry{storage, vector.size()});
+    } catch (...) {
+      _hashes.erase(storage);
+      throw;
+    }
+    storage->_registry.store(this, std::memory_order_release);
+    return nullptr;
+  }
+
+  void forget(void* storage) noexcept override {
+    std::lock_guard lock(_mutex);
+    auto* removed = static_cast<dynamic_storage*>(storage);
+    auto hash_it = _hashes.find(removed);
+    if (hash_it == _hashes.end()) {
+      return;
+    }
+    auto [first, last] = _entries.equal_range(hash_it->second);
+    for (auto it = first; it != last; ++it) {
+      if (it->second.storage == removed) {
+        _entries.erase(it);
+        break;
+      }
+    }
+    _hashes.erase(hash_it);
+  }
+
+private:
+  mutable std::mutex _mutex;
+  std::unordered_multimap<size_t, entry> _entries;
+  std::unordered_map<dynamic_storage*, size_t> _hashes;
+};
+
+template <typename T, size_t SMALL_SIZE, size_t ALIGNMENT>
+bool socow_intern(socow_vector<T, SMALL_SIZE, ALIGNMENT>& vector,
+                  socow_intern_table<T, SMALL_SIZE, ALIGNMENT>& table) {
+  return table.intern(vector);
+}
+
+template <typename T, size_t SMALL_SIZE, size_t ALIGNMENT>
+bool socow_intern(socow_vector<T, SMALL_SIZE, ALIGNMENT>& vector) {
+  static socow_intern_table<T, SMALL_SIZE, ALIGNMENT> table;
+  return table.intern(vector);
+}
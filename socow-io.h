@@ -0,0 +1,77 @@
+#pragma once
+
+#include "socow-vector.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstddef>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+#include <sys/types.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+template <typename T, size_t SMALL_SIZE, size_t ALIGNMENT>
+ssize_t socow_append_from_fd(socow_vector<T, SMALL_SIZE, ALIGNMENT>& vector, int fd, size_t max_bytes) {
+  static_assert(sizeof(T) == 1 && std::is_trivially_copyable_v<T>, "only byte vectors can be read into");
+  size_t size = vector.size();
+  if (size + max_bytes > vector.capacity()) {
+    vector.reserve(std::max(size + max_bytes, vector.capacity() * 2));
+  }
+  T* tail = vector.data() + size;
+  ssize_t done;
+  do {
+    done = read(fd, tail, max_bytes);
+  } while (done < 0 && errno == EINTR);
+  if (done > 0) {
+    socow_detail::storage_access::commit_size(vector, size + static_cast<size_t>(done));
+  }
+  return done;
+}
+
+template <typename T, size_t SMALL_SIZE, size_t ALIGNMENT>
+ssize_t socow_write_to_fd(int fd, std::span<const socow_vector<T, SMALL_SIZE, ALIGNMENT>> vectors) {
+  static_assert(std::is_trivially_copyable_v<T>, "only trivially copyable elements can be written");
+  std::vector<iovec> buffers;
+  buffers.reserve(vectors.size());
+  for (const auto& vector : vectors) {
+    if (!vector.empty()) {
+      buffers.push_back({const_cast<T*>(vector.data()), vector.size() * sizeof(T)});
+    }
+  }
+
+  ssize_t total = 0;
+  size_t first = 0;
+  while (first < buffers.size()) {
+    int count = static_cast<int>(std::min<size_t>(buffers.size() - first, IOV_MAX));
+    ssize_t done = writev(fd, buffers.data() + first, count);
+    if (done < 0 && errno == EINTR) {
+      continue;
+    }
+    if (done < 0) {
+      return total == 0 ? -1 : total;
+    }
+    if (done == 0) {
+      return total;
+    }
+    total += done;
+    size_t left = static_cast<size_t>(done);
+    while (first < buffers.size() && left >= buffers[first].iov_len) {
+      left -= buffers[first].iov_len;
+      ++first;
+    }
+    if (left > 0) {
+      buffers[first].iov_base = static_cast<char*>(buffers[first].iov_base) + left;
+      buffers[first].iov_len -= left;
+    }
+  }
+  return total;
+}
+
+template <typename T, size_t SMALL_SIZE, size_t ALIGNMENT>
+ssize_t socow_write_to_fd(int fd, const socow_vector<T, SMALL_SIZE, ALIGNMENT>& vector) {
+  return socow_write_to_fd(fd, std::span<const socow_vector<T, SMALL_SIZE, ALIGNMENT>>(&vector, 1));
+}
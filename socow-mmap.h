@@ -0,0 +1,234 @@
+#pragma once
+
+#include "socow-vector.h"
+
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace socow_detail {
+
+struct snapshot_header {
+  static constexpr uint64_t MAGIC = 0x31706e73776f636f;
+  static constexpr uint32_t VERSION = 1;
+
+  uint64_t magic;
+  uint32_t version;
+  uint32_t element_size;
+  uint64_t block_alignment;
+  uint64_t count;
+};
+
+struct snapshot_entry {
+  uint64_t offset;
+  uint64_t size;
+};
+
+class file_mapping final : public external_buffer {
+public:
+  static file_mapping* open(const std::string& path) {
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+      throw std::system_error(errno, std::generic_category(), "open " + path);
+    }
+    struct stat status;
+    if (fstat(fd, &status) != 0) {
+      int error = errno;
+      close(fd);
+      throw std::system_error(error, std::generic_category(), "fstat " + path);
+    }
+    size_t size = static_cast<size_t>(status.st_size);
+    void* base = size == 0 ? nullptr : mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    int error = errno;
+    close(fd);
+    if (base == MAP_FAILED) {
+      throw std::system_error(error, std::generic_category(), "mmap " + path);
+    }
+    return new file_mapping(base, size);
+  }
+
+  file_mapping(const file_mapping&) = delete;
+  file_mapping& operator=(const file_mapping&) = delete;
+
+  void retain() noexcept {
+    _references.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  void unref() noexcept {
+    if (_references.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      delete this;
+    }
+  }
+
+  void release(void*, size_t) noexcept override {
+    unref();
+  }
+
+  const char* bytes() const noexcept {
+    return static_cast<const char*>(_base);
+  }
+
+  size_t size() const noexcept {
+    return _size;
+  }
+
+private:
+  file_mapping(void* base, size_t size) noexcept : _base(base), _size(size) {}
+
+  ~file_mapping() {
+    if (_base != nullptr) {
+      munmap(_base, _size);
+    }
+  }
+
+  std::atomic<size_t> _references{1};
+  void* _base;
+  size_t _size;
+};
+
+} // namespace socow_detail
+
+class socow_snapshot {
+public:
+  static socow_snapshot open(const std::string& path) {
+    socow_snapshot result(socow_detail::file_mapping::open(path));
+    result.validate();
+    return result;
+  }
+
+  socow_snapshot(socow_snapshot&& other) noexcept : _mapping(std::exchange(other._mapping, nullptr)) {}
+
+  socow_snapshot& operator=(socow_snapshot&& other) noexcept {
+    if (this != &other) {
+      if (_mapping != nullptr) {
+        _mapping->unref();
+      }
+      _mapping = std::exchange(other._mapping, nullptr);
+    }
+    return *this;
+  }
+
+  ~socow_snapshot() {
+    if (_mapping != nullptr) {
+      _mapping->unref();
+    }
+  }
+
+  size_t size() const noexcept {
+    return header().count;
+  }
+
+  template <typename T, size_t SMALL_SIZE, size_t ALIGNMENT = alignof(T)>
+  socow_vector<T, SMALL_SIZE, ALIGNMENT> get(size_t index) const {
+    using vector_type = socow_vector<T, SMALL_SIZE, ALIGNMENT>;
+    static_assert(std::is_trivially_copyable_v<T>, "only trivially copyable elements can be mapped");
+    if (header().element_size != sizeof(T)) {
+      throw std::invalid_argument("socow_snapshot: element size mismatch");
+    }
+    if (index >= size()) {
+      throw std::out_of_range("socow_snapshot: index is out of range");
+    }
+    const socow_detail::snapshot_entry& entry = entries()[index];
+    auto* elements = reinterpret_cast<T*>(const_cast<char*>(_mapping->bytes() + entry.offset));
+    if (entry.size <= SMALL_SIZE || reinterpret_cast<uintptr_t>(elements) % ALIGNMENT != 0) {
+      vector_type result;
+      result.reserve(entry.size);
+      for (size_t i = 0; i < entry.size; ++i) {
+        result.push_back(elements[i]);
+      }
+      return result;
+    }
+    _mapping->retain();
+    return socow_detail::storage_access::adopt_external<vector_type>(elements, entry.size, entry.size, _mapping, true);
+  }
+
+private:
+  explicit socow_snapshot(socow_detail::file_mapping* mapping) noexcept : _mapping(mapping) {}
+
+  const socow_detail::snapshot_header& header() const noexcept {
+    return *reinterpret_cast<const socow_detail::snapshot_header*>(_mapping->bytes());
+  }
+
+  const socow_detail::snapshot_entry* entries() const noexcept {
+    return reinterpret_cast<const socow_detail::snapshot_entry*>(_mapping->bytes() + sizeof(socow_detail::snapshot_header));
+  }
+
+  void validate() const {
+    size_t file_size = _mapping->size();
+    if (file_size < sizeof(socow_detail::snapshot_header) || header().magic != socow_detail::snapshot_header::MAGIC ||
+        header().version != socow_detail::snapshot_header::VERSION) {
+      throw std::runtime_error("socow_snapshot: not a snapshot file");
+    }
+    uint64_t count = header().count;
+    if (count > (file_size - sizeof(socow_detail::snapshot_header)) / sizeof(socow_detail::snapshot_entry)) {
+      throw std::runtime_error("socow_snapshot: truncated entry table");
+    }
+    for (uint64_t i = 0; i < count; ++i) {
+      const socow_detail::snapshot_entry& entry = entries()[i];
+      if (entry.offset > file_size || entry.size > (file_size - entry.offset) / std::max<uint32_t>(header().element_size, 1)) {
+        throw std::runtime_error("socow_snapshot: truncated data block");
+      }
+    }
+  }
+
+  socow_detail::file_mapping* _mapping;
+};
+
+template <typename T, size_t SMALL_SIZE, size_t ALIGNMENT>
+void socow_save(const std::string& path, std::span<const socow_vector<T, SMALL_SIZE, ALIGNMENT>> vectors) {
+  static_assert(std::is_trivially_copyable_v<T>, "only trivially copyable elements can be saved");
+  constexpr uint64_t BLOCK_ALIGNMENT = std::max<uint64_t>(ALIGNMENT, 64);
+  auto align = [](uint64_t offset) { return (offset + BLOCK_ALIGNMENT - 1) / BLOCK_ALIGNMENT * BLOCK_ALIGNMENT; };
+
+  socow_detail::snapshot_header header{socow_detail::snapshot_header::MAGIC, socow_detail::snapshot_header::VERSION,
+                                       sizeof(T), BLOCK_ALIGNMENT, vectors.size()};
+  std::vector<socow_detail::snapshot_entry> entries;
+  entries.reserve(vectors.size());
+  uint64_t offset = align(sizeof(header) + sizeof(socow_detail::snapshot_entry) * vectors.size());
+  for (const auto& vector : vectors) {
+    entries.push_back({offset, vector.size()});
+    offset = align(offset + vector.size() * sizeof(T));
+  }
+
+  std::ofstream out(path, std::ios::binary | std::ios::trunc);
+  static constexpr char padding[BLOCK_ALIGNMENT] = {};
+  uint64_t written = 0;
+  auto write = [&](const void* bytes, uint64_t length) {
+    out.write(static_cast<const char*>(bytes), static_cast<std::streamsize>(length));
+    written += length;
+  };
+  write(&header, sizeof(header));
+  write(entries.data(), sizeof(socow_detail::snapshot_entry) * entries.size());
+  for (size_t i = 0; i < vectors.size(); ++i) {
+    write(padding, entries[i].offset - written);
+    write(vectors[i].data(), vectors[i].size() * sizeof(T));
+  }
+  out.flush();
+  if (!out) {
+    throw std::runtime_error("socow_save: cannot write " + path);
+  }
+}
+
+template <typename T, size_t SMALL_SIZE, size_t ALIGNMENT>
+void socow_save(const std::string& path, const socow_vector<T, SMALL_SIZE, ALIGNMENT>& vector) {
+  socow_save(path, std::span<const socow_vector<T, SMALL_SIZE, ALIGNMENT>>(&vector, 1));
+}
+
+template <typename T, size_t SMALL_SIZE, size_t ALIGNMENT = alignof(T)>
+socow_vector<T, SMALL_SIZE, ALIGNMENT> socow_load(const std::string& path) {
+  return socow_snapshot::open(path).get<T, SMALL_SIZE, ALIGNMENT>(0);
+}
@@ -0,0 +1,312 @@
+#pragma once
+
+#include "socow-vector.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <optional>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace socow_parallel {
+
+class pool {
+public:
+  explicit pool(size_t threads = std::max<size_t>(std::thread::hardware_concurrency(), 1))
+      : _ranges(std::make_unique<range[]>(threads)), _participants(threads) {
+    _workers.reserve(threads - 1);
+    for (size_t i = 1; i < threads; ++i) {
+      _workers.emplace_back([this, i] { work(i); });
+    }
+  }
+
+  pool(const pool&) = delete;
+  pool& operator=(const pool&) = delete;
+
+  ~pool() {
+    {
+      std::lock_guard lock(_mutex);
+      _stopping = true;
+    }
+    _wake.notify_all();
+    for (std::thread& worker : _workers) {
+      worker.join();
+    }
+  }
+
+  size_t concurrency() const noexcept {
+    return _participants;
+  }
+
+  template <typename F>
+  void run(size_t chunks, F&& body) {
+    if (chunks == 0) {
+      return;
+    }
+    if (chunks == 1 || _participants == 1 || inside_worker()) {
+      for (size_t chunk = 0; chunk < chunks; ++chunk) {
+        body(chunk);
+      }
+      return;
+    }
+
+    std::lock_guard run_lock(_run_mutex);
+    size_t participants = std::min(_participants, chunks);
+    for (size_t i = 0; i < _participants; ++i) {
+      uint64_t first = i < participants ? chunks * i / participants : 0;
+      uint64_t last = i < participants ? chunks * (i + 1) / participants : 0;
+      _ranges[i].bounds.store(first << 32 | last, std::memory_order_relaxed);
+    }
+    using body_type = std::remove_reference_t<F>;
+    _job = {const_cast<void*>(static_cast<const void*>(&body)),
+            [](void* context, size_t chunk) { (*static_cast<body_type*>(context))(chunk); }};
+    _error = nullptr;
+    _failed.store(false, std::memory_order_relaxed);
+    {
+      std::lock_guard lock(_mutex);
+      _busy = _workers.size();
+      ++_generation;
+    }
+    _wake.notify_all();
+
+    inside_worker() = true;
+    process(0);
+    inside_worker() = false;
+
+    std::unique_lock lock(_mutex);
+    _done.wait(lock, [this] { return _busy == 0; });
+    if (_error != nullptr) {
+      std::rethrow_exception(_error);
+    }
+  }
+
+private:
+  struct alignas(64) range {
+    std::atomic<uint64_t> bounds{0};
+  };
+
+  struct job {
+    void* context = nullptr;
+    void (*invoke)(void* context, size_t chunk) = nullptr;
+  };
+
+  static bool& inside_worker() noexcept {
+    thread_local bool inside = false;
+    return inside;
+  }
+
+  static bool take_front(range& from, size_t& chunk) noexcept {
+    uint64_t bounds = from.bounds.load(std::memory_order_relaxed);
+    while (true) {
+      uint64_t first = bounds >> 32;
+      uint64_t last = bounds & 0xffffffff;
+      if (first >= last) {
+        return false;
+      }
+      if (from.bounds.compare_exchange_weak(bounds, (first + 1) << 32 | last, std::memory_order_acq_rel)) {
+        chunk = first;
+        return true;
+      }
+    }
+  }
+
+  static bool steal_back(range& from, size_t& chunk) noexcept {
+    uint64_t bounds = from.bounds.load(std::memory_order_relaxed);
+    while (true) {
+      uint64_t first = bounds >> 32;
+      uint64_t last = bounds & 0xffffffff;
+      if (first >= last) {
+        return false;
+      }
+      if (from.bounds.compare_exchange_weak(bounds, first << 32 | (last - 1), std::memory_order_acq_rel)) {
+        chunk = last - 1;
+        return true;
+      }
+    }
+  }
+
+  void execute(size_t chunk) noexcept {
+    if (_failed.load(std::memory_order_relaxed)) {
+      return;
+    }
+    try {
+      _job.invoke(_job.context, chunk);
+    } catch (...) {
+      std::lock_guard lock(_mutex);
+      if (_error == nullptr) {
+        _error = std::current_exception();
+      }
+      _failed.store(true, std::memory_order_relaxed);
+    }
+  }
+
+  void process(size_t self) noexcept {
+    size_t chunk;
+    while (take_front(_ranges[self], chunk)) {
+      execute(chunk);
+    }
+    for (size_t offset = 1; offset < _participants; ++offset) {
+      range& victim = _ranges[(self + offset) % _participants];
+      while (steal_back(victim, chunk)) {
+        execute(chunk);
+      }
+    }
+  }
+
+  void work(size_t self) {
+    inside_worker() = true;
+    uint64_t seen = 0;
+    while (true) {
+      {
+        std::unique_lock lock(_mutex);
+        _wake.wait(lock, [&] { return _stopping || _generation != seen; });
+        if (_stopping) {
+          return;
+        }
+        seen = _generation;
+      }
+      process(self);
+      {
+        std::lock_guard lock(_mutex);
+        --_busy;
+      }
+      _done.notify_one();
+    }
+  }
+
+  std::unique_ptr<range[]> _ranges;
+  size_t _participants;
+  std::vector<std::thread> _workers;
+  std::mutex _run_mutex;
+  std::mutex _mutex;
+  std::condition_variable _wake;
+  std::condition_variable _done;
+  size_t _busy = 0;
+  uint64_t _generation = 0;
+  bool _stopping = false;
+  job _job;
+  std::exception_ptr _error;
+  std::atomic<bool> _failed{false};
+};
+
+inline pool& default_pool() {
+  static pool result;
+  return result;
+}
+
+namespace detail {
+
+constexpr size_t CACHE_LINE = 64;
+constexpr size_t MIN_CHUNK_BYTES = 64 * 1024;
+constexpr size_t CHUNKS_PER_PARTICIPANT = 8;
+
+template <typename T>
+class chunking {
+public:
+  chunking(const T* data, size_t size, size_t participants) noexcept : _size(size) {
+    size_t misalignment = reinterpret_cast<uintptr_t>(data) % CACHE_LINE;
+    size_t head_bytes = (CACHE_LINE - misalignment) % CACHE_LINE;
+    _head = head_bytes % sizeof(T) == 0 ? std::min(head_bytes / sizeof(T), size) : 0;
+    size_t step = std::lcm(sizeof(T), CACHE_LINE) / sizeof(T);
+    size_t wanted = std::max(MIN_CHUNK_BYTES / sizeof(T), size / (participants * CHUNKS_PER_PARTICIPANT));
+    _chunk = std::max<size_t>((wanted + step - 1) / step * step, 1);
+    _count = size == 0 ? 0 : 1 + (size - std::min(size, _head + _chunk) + _chunk - 1) / _chunk;
+  }
+
+  size_t count() const noexcept {
+    return _count;
+  }
+
+  std::pair<size_t, size_t> bounds(size_t chunk) const noexcept {
+    size_t first = chunk == 0 ? 0 : _head + chunk * _chunk;
+    size_t last = std::min(_head + (chunk + 1) * _chunk, _size);
+    return {first, last};
+  }
+
+private:
+  size_t _size;
+  size_t _head;
+  size_t _chunk;
+  size_t _count;
+};
+
+template <typename T, typename F>
+void for_each_chunk(T* data, size_t size, pool& workers, F body) {
+  chunking<T> chunks(data, size, workers.concurrency());
+  workers.run(chunks.count(), [&](size_t chunk) {
+    auto [first, last] = chunks.bounds(chunk);
+    body(data + first, data + last, first);
+  });
+}
+
+} // namespace detail
+
+template <typename T, size_t SMALL_SIZE, size_t ALIGNMENT, typename F>
+void for_each(socow_vector<T, SMALL_SIZE, ALIGNMENT>& vector, F f, pool& workers = default_pool()) {
+  detail::for_each_chunk(vector.data(), vector.size(), workers, [&](T* first, T* last, size_t) {
+    std::for_each(first, last, f);
+  });
+}
+
+template <typename T, size_t SMALL_SIZE, size_t ALIGNMENT, typename F>
+void for_each(const socow_vector<T, SMALL_SIZE, ALIGNMENT>& vector, F f, pool& workers = default_pool()) {
+  detail::for_each_chunk(vector.data(), vector.size(), workers, [&](const T* first, const T* last, size_t) {
+    std::for_each(first, last, f);
+  });
+}
+
+template <typename T, size_t SMALL_SIZE, size_t ALIGNMENT, typename F>
+void transform(socow_vector<T, SMALL_SIZE, ALIGNMENT>& vector, F f, pool& workers = default_pool()) {
+  detail::for_each_chunk(vector.data(), vector.size(), workers, [&](T* first, T* last, size_t) {
+    std::transform(first, last, first, f);
+  });
+}
+
+template <typename T, size_t SMALL_SIZE, size_t ALIGNMENT, typename U, size_t OUTPUT_SMALL_SIZE, size_t OUTPUT_ALIGNMENT,
+          typename F>
+void transform(const socow_vector<T, SMALL_SIZE, ALIGNMENT>& source,
+               socow_vector<U, OUTPUT_SMALL_SIZE, OUTPUT_ALIGNMENT>& destination, F f, pool& workers = default_pool()) {
+  assert(destination.size() == source.size());
+  U* output = destination.data();
+  detail::for_each_chunk(source.data(), source.size(), workers, [&](const T* first, const T* last, size_t offset) {
+    std::transform(first, last, output + offset, f);
+  });
+}
+
+template <typename T, size_t SMALL_SIZE, size_t ALIGNMENT>
+void fill(socow_vector<T, SMALL_SIZE, ALIGNMENT>& vector, const T& value, pool& workers = default_pool()) {
+  detail::for_each_chunk(vector.data(), vector.size(), workers, [&](T* first, T* last, size_t) {
+    std::fill(first, last, value);
+  });
+}
+
+template <typename T, size_t SMALL_SIZE, size_t ALIGNMENT, typename R, typename Op = std::plus<>>
+R reduce(const socow_vector<T, SMALL_SIZE, ALIGNMENT>& vector, R init, Op op = {}, pool& workers = default_pool()) {
+  const T* data = vector.data();
+  detail::chunking<T> chunks(data, vector.size(), workers.concurrency());
+  std::vector<std::optional<R>> partial(chunks.count());
+  workers.run(chunks.count(), [&](size_t chunk) {
+    auto [first, last] = chunks.bounds(chunk);
+    R result = static_cast<R>(data[first]);
+    for (size_t i = first + 1; i < last; ++i) {
+      result = op(std::move(result), data[i]);
+    }
+    partial[chunk].emplace(std::move(result));
+  });
+  for (std::optional<R>& result : partial) {
+    init = op(std::move(init), std::move(*result));
+  }
+  return init;
+}
+
+} // namespace socow_parallel
@@ -0,0 +1,133 @@
+#pragma once
+
+#include <array>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <thread>
+
+#ifndef SOCOW_VECTOR_ASYNC_RECLAMATION
+#define SOCOW_VECTOR_ASYNC_RECLAMATION 0
+#endif
+
+#ifndef SOCOW_VECTOR_ASYNC_RECLAMATION_THRESHOLD
+#define SOCOW_VECTOR_ASYNC_RECLAMATION_THRESHOLD (1 << 20)
+#endif
+
+#ifndef SOCOW_VECTOR_ASYNC_RECLAMATION_QUEUE
+#define SOCOW_VECTOR_ASYNC_RECLAMATION_QUEUE 64
+#endif
+
+namespace socow_detail {
+
+class background_worker {
+public:
+  using job = void (*)(void* pointer, size_t length) noexcept;
+
+  static constexpr size_t RECLAIM_THRESHOLD = SOCOW_VECTOR_ASYNC_RECLAMATION_THRESHOLD;
+  static constexpr size_t QUEUE_CAPACITY = SOCOW_VECTOR_ASYNC_RECLAMATION_QUEUE;
+
+  static bool post(void* pointer, size_t length, job run) noexcept {
+    return !destroyed() && instance().try_post(pointer, length, run);
+  }
+
+  static background_worker& instance() {
+    static background_worker result;
+    return result;
+  }
+
+  background_worker(const background_worker&) = delete;
+  background_worker& operator=(const background_worker&) = delete;
+
+  ~background_worker() {
+    destroyed() = true;
+    {
+      std::lock_guard lock(_mutex);
+      _stopping = true;
+    }
+    _wake.notify_one();
+    if (_worker.joinable()) {
+      _worker.join();
+    }
+  }
+
+  void drain() {
+    std::unique_lock lock(_mutex);
+    _idle.wait(lock, [this] { return _count == 0 && !_busy; });
+  }
+
+private:
+  struct queued_job {
+    void* pointer;
+    size_t length;
+    job run;
+  };
+
+  background_worker() = default;
+
+  static bool& destroyed() noexcept {
+    static bool value = false;
+    return value;
+  }
+
+  bool try_post(void* pointer, size_t length, job run) noexcept {
+    {
+      std::lock_guard lock(_mutex);
+      if (_stopping || _count == QUEUE_CAPACITY || !started()) {
+        return false;
+      }
+      _queue[(_head + _count) % QUEUE_CAPACITY] = {pointer, length, run};
+      ++_count;
+    }
+    _wake.notify_one();
+    return true;
+  }
+
+  bool started() noexcept {
+    if (!_worker.joinable()) {
+      try {
+        _worker = std::thread([this] { work(); });
+      } catch (...) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  void work() {
+    std::unique_lock lock(_mutex);
+    while (true) {
+      _wake.wait(lock, [this] { return _stopping || _count != 0; });
+      if (_count == 0) {
+        return;
+      }
+      queued_job item = _queue[_head];
+      _head = (_head + 1) % QUEUE_CAPACITY;
+      --_count;
+      _busy = true;
+      lock.unlock();
+      item.run(item.pointer, item.length);
+      lock.lock();
+      _busy = false;
+      if (_count == 0) {
+        _idle.notify_all();
+      }
+    }
+  }
+
+  std::mutex _mutex;
+  std::condition_variable _wake;
+  std::condition_variable _idle;
+  std::array<queued_job, QUEUE_CAPACITY> _queue;
+  size_t _head = 0;
+  size_t _count = 0;
+  bool _busy = false;
+  bool _stopping = false;
+  std::thread _worker;
+};
+
+} // namespace socow_detail
+
+inline void socow_reclaim_drain() {
+  socow_detail::background_worker::instance().drain();
+}
@@ -0,0 +1,177 @@
+#pragma once
+
+#include "socow-vector.h"
+
+#include <cerrno>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+struct socow_shm_handle {
+  size_t offset;
+  size_t size;
+};
+
+class socow_shm_segment {
+public:
+  static socow_shm_segment create(size_t bytes) {
+    int fd = memfd_create("socow-vector", MFD_CLOEXEC);
+    if (fd < 0) {
+      throw std::system_error(errno, std::generic_category(), "memfd_create");
+    }
+    if (ftruncate(fd, static_cast<off_t>(bytes)) != 0) {
+      int error = errno;
+      close(fd);
+      throw std::system_error(error, std::generic_category(), "ftruncate");
+    }
+    socow_shm_segment result(fd, bytes);
+    result._arena = socow_detail::shared_arena::create(result._base, bytes);
+    if (result._arena == nullptr) {
+      throw std::invalid_argument("socow_shm_segment: segment is too small");
+    }
+    return result;
+  }
+
+  static socow_shm_segment open(int fd) {
+    int owned = dup(fd);
+    if (owned < 0) {
+      throw std::system_error(errno, std::generic_category(), "dup");
+    }
+    struct stat status;
+    if (fstat(owned, &status) != 0) {
+      int error = errno;
+      close(owned);
+      throw std::system_error(error, std::generic_category(), "fstat");
+    }
+    socow_shm_segment result(owned, static_cast<size_t>(status.st_size));
+    result._arena = socow_detail::shared_arena::attach(result._base, result._size);
+    if (result._arena == nullptr) {
+      throw std::invalid_argument("socow_shm_segment: descriptor is not a socow segment");
+    }
+    return result;
+  }
+
+  socow_shm_segment(socow_shm_segment&& other) noexcept
+      : _fd(std::exchange(other._fd, -1)), _size(std::exchange(other._size, 0)),
+        _base(std::exchange(other._base, nullptr)), _arena(std::exchange(other._arena, nullptr)) {}
+
+  socow_shm_segment& operator=(socow_shm_segment&& other) noexcept {
+    if (this != &other) {
+      release();
+      _fd = std::exchange(other._fd, -1);
+      _size = std::exchange(other._size, 0);
+      _base = std::exchange(other._base, nullptr);
+      _arena = std::exchange(other._arena, nullptr);
+    }
+    return *this;
+  }
+
+  ~socow_shm_segment() {
+    release();
+  }
+
+  int fd() const noexcept {
+    return _fd;
+  }
+
+  template <typename T, size_t SMALL_SIZE, size_t ALIGNMENT>
+  bool contains(const socow_vector<T, SMALL_SIZE, ALIGNMENT>& vector) const noexcept {
+    auto* storage = socow_detail::storage_access::storage(vector);
+    return storage != nullptr && storage->arena() == _arena;
+  }
+
+  template <typename T, size_t SMALL_SIZE, size_t ALIGNMENT>
+  socow_vector<T, SMALL_SIZE, ALIGNMENT> copy(const socow_vector<T, SMALL_SIZE, ALIGNMENT>& vector) {
+    using vector_type = socow_vector<T, SMALL_SIZE, ALIGNMENT>;
+    using storage_type = socow_detail::storage_access::storage_type<vector_type>;
+    static_assert(std::is_trivially_copyable_v<T>, "only trivially copyable elements can live in shared memory");
+    static_assert(alignof(storage_type) <= socow_detail::shared_arena::BLOCK_ALIGNMENT);
+
+    size_t capacity = std::max(vector.size(), SMALL_SIZE + 1);
+    size_t bytes = sizeof(storage_type) + sizeof(T) * capacity;
+    void* memory = _arena->allocate(bytes);
+    if (memory == nullptr) {
+      throw std::bad_alloc();
+    }
+    socow_stats::detail::on_allocation(bytes);
+    auto* storage = new (memory) storage_type(capacity);
+    storage->_arena_distance = reinterpret_cast<char*>(storage) - reinterpret_cast<char*>(_arena);
+    std::uninitialized_copy_n(vector.data(), vector.size(), storage->_data);
+    socow_stats::detail::on_copy(vector.size() * sizeof(T));
+    socow_detail::arena_mappings::retain(_base);
+    return socow_detail::storage_access::adopt<vector_type>(storage, vector.size());
+  }
+
+  template <typename T, size_t SMALL_SIZE, size_t ALIGNMENT>
+  socow_shm_handle share(const socow_vector<T, SMALL_SIZE, ALIGNMENT>& vector) {
+    if (!contains(vector)) {
+      return share(copy(vector));
+    }
+    auto* storage = socow_detail::storage_access::storage(vector);
+    storage->inc_handle_references();
+    return {_arena->offset_of(storage), vector.size()};
+  }
+
+  template <typename T, size_t SMALL_SIZE, size_t ALIGNMENT = alignof(T)>
+  socow_vector<T, SMALL_SIZE, ALIGNMENT> adopt(socow_shm_handle handle) {
+    using vector_type = socow_vector<T, SMALL_SIZE, ALIGNMENT>;
+    using storage_type = socow_detail::storage_access::storage_type<vector_type>;
+    if (handle.offset > _size || _size - handle.offset < sizeof(storage_type) ||
+        !_arena->contains(_arena->at(handle.offset))) {
+      throw std::out_of_range("socow_shm_segment: handle is outside of the segment");
+    }
+    auto* storage = static_cast<storage_type*>(_arena->at(handle.offset));
+    if (storage->arena() != _arena || storage->capacity() < handle.size) {
+      throw std::invalid_argument("socow_shm_segment: handle does not describe a vector");
+    }
+    size_t elements = _arena->offset_of(storage->elements());
+    if (elements > _size || (_size - elements) / sizeof(T) < storage->capacity()) {
+      throw std::out_of_range("socow_shm_segment: vector is outside of the segment");
+    }
+    socow_detail::arena_mappings::retain(_base);
+    return socow_detail::storage_access::adopt<vector_type>(storage, handle.size);
+  }
+
+private:
+  socow_shm_segment(int fd, size_t size) : _fd(fd), _size(size) {
+    _base = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (_base == MAP_FAILED) {
+      int error = errno;
+      close(fd);
+      throw std::system_error(error, std::generic_category(), "mmap");
+    }
+    try {
+      socow_detail::arena_mappings::map(_base, size, &unmap);
+    } catch (...) {
+      unmap(_base, size);
+      close(fd);
+      throw;
+    }
+  }
+
+  static void unmap(void* base, size_t bytes) noexcept {
+    munmap(base, bytes);
+  }
+
+  void release() noexcept {
+    if (_base != nullptr) {
+      socow_detail::arena_mappings::release(_base);
+    }
+    if (_fd >= 0) {
+      close(_fd);
+    }
+  }
+
+  int _fd = -1;
+  size_t _size = 0;
+  void* _base = nullptr;
+  socow_detail::shared_arena* _arena = nullptr;
+};
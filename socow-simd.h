@@ -0,0 +1,199 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define SOCOW_SIMD_X86 1
+#include <immintrin.h>
+#else
+#define SOCOW_SIMD_X86 0
+#endif
+
+namespace socow_detail {
+
+template <typename T>
+inline constexpr bool simd_searchable =
+    std::is_arithmetic_v<T> && (sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4 || sizeof(T) == 8);
+
+template <typename T>
+size_t scalar_find(const T* data, size_t size, const T& value) {
+  return static_cast<size_t>(std::find(data, data + size, value) - data);
+}
+
+template <typename T>
+size_t scalar_count(const T* data, size_t size, const T& value) {
+  return static_cast<size_t>(std::count(data, data + size, value));
+}
+
+#if SOCOW_SIMD_X86
+
+template <size_t N>
+using lane_bits_t = std::conditional_t<
+    N == 1, uint8_t, std::conditional_t<N == 2, uint16_t, std::conditional_t<N == 4, uint32_t, uint64_t>>>;
+
+template <typename T>
+lane_bits_t<sizeof(T)> lane_bits(const T& value) noexcept {
+  lane_bits_t<sizeof(T)> bits;
+  std::memcpy(&bits, &value, sizeof(T));
+  return bits;
+}
+
+template <typename T>
+__m128i sse2_broadcast(const T& value) noexcept {
+  auto bits = lane_bits(value);
+  if constexpr (sizeof(T) == 1) {
+    return _mm_set1_epi8(static_cast<char>(bits));
+  } else if constexpr (sizeof(T) == 2) {
+    return _mm_set1_epi16(static_cast<short>(bits));
+  } else if constexpr (sizeof(T) == 4) {
+    return _mm_set1_epi32(static_cast<int>(bits));
+  } else {
+    return _mm_set1_epi64x(static_cast<long long>(bits));
+  }
+}
+
+template <typename T>
+unsigned sse2_match_mask(__m128i chunk, __m128i needle) noexcept {
+  __m128i eq;
+  if constexpr (std::is_same_v<T, float>) {
+    eq = _mm_castps_si128(_mm_cmpeq_ps(_mm_castsi128_ps(chunk), _mm_castsi128_ps(needle)));
+  } else if constexpr (std::is_same_v<T, double>) {
+    eq = _mm_castpd_si128(_mm_cmpeq_pd(_mm_castsi128_pd(chunk), _mm_castsi128_pd(needle)));
+  } else if constexpr (sizeof(T) == 1) {
+    eq = _mm_cmpeq_epi8(chunk, needle);
+  } else if constexpr (sizeof(T) == 2) {
+    eq = _mm_cmpeq_epi16(chunk, needle);
+  } else if constexpr (sizeof(T) == 4) {
+    eq = _mm_cmpeq_epi32(chunk, needle);
+  } else {
+    eq = _mm_cmpeq_epi32(chunk, needle);
+    eq = _mm_and_si128(eq, _mm_shuffle_epi32(eq, _MM_SHUFFLE(2, 3, 0, 1)));
+  }
+  return static_cast<unsigned>(_mm_movemask_epi8(eq));
+}
+
+template <typename T>
+size_t sse2_find(const T* data, size_t size, const T& value) noexcept {
+  constexpr size_t lanes = 16 / sizeof(T);
+  __m128i needle = sse2_broadcast(value);
+  size_t i = 0;
+  for (; i + lanes <= size; i += lanes) {
+    __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+    unsigned mask = sse2_match_mask<T>(chunk, needle);
+    if (mask != 0) {
+      return i + static_cast<size_t>(__builtin_ctz(mask)) / sizeof(T);
+    }
+  }
+  return i + scalar_find(data + i, size - i, value);
+}
+
+template <typename T>
+size_t sse2_count(const T* data, size_t size, const T& value) noexcept {
+  constexpr size_t lanes = 16 / sizeof(T);
+  __m128i needle = sse2_broadcast(value);
+  size_t result = 0;
+  size_t i = 0;
+  for (; i + lanes <= size; i += lanes) {
+    __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+    result += static_cast<size_t>(__builtin_popcount(sse2_match_mask<T>(chunk, needle)));
+  }
+  return result / sizeof(T) + scalar_count(data + i, size - i, value);
+}
+
+template <typename T>
+__attribute__((target("avx2"))) __m256i avx2_broadcast(const T& value) noexcept {
+  auto bits = lane_bits(value);
+  if constexpr (sizeof(T) == 1) {
+    return _mm256_set1_epi8(static_cast<char>(bits));
+  } else if constexpr (sizeof(T) == 2) {
+    return _mm256_set1_epi16(static_cast<short>(bits));
+  } else if constexpr (sizeof(T) == 4) {
+    return _mm256_set1_epi32(static_cast<int>(bits));
+  } else {
+    return _mm256_set1_epi64x(static_cast<long long>(bits));
+  }
+}
+
+template <typename T>
+__attribute__((target("avx2"))) unsigned avx2_match_mask(__m256i chunk, __m256i needle) noexcept {
+  __m256i eq;
+  if constexpr (std::is_same_v<T, float>) {
+    eq = _mm256_castps_si256(_mm256_cmp_ps(_mm256_castsi256_ps(chunk), _mm256_castsi256_ps(needle), _CMP_EQ_OQ));
+  } else if constexpr (std::is_same_v<T, double>) {
+    eq = _mm256_castpd_si256(_mm256_cmp_pd(_mm256_castsi256_pd(chunk), _mm256_castsi256_pd(needle), _CMP_EQ_OQ));
+  } else if constexpr (sizeof(T) == 1) {
+    eq = _mm256_cmpeq_epi8(chunk, needle);
+  } else if constexpr (sizeof(T) == 2) {
+    eq = _mm256_cmpeq_epi16(chunk, needle);
+  } else if constexpr (sizeof(T) == 4) {
+    eq = _mm256_cmpeq_epi32(chunk, needle);
+  } else {
+    eq = _mm256_cmpeq_epi64(chunk, needle);
+  }
+  return static_cast<unsigned>(_mm256_movemask_epi8(eq));
+}
+
+template <typename T>
+__attribute__((target("avx2"))) size_t avx2_find(const T* data, size_t size, const T& value) noexcept {
+  constexpr size_t lanes = 32 / sizeof(T);
+  __m256i needle = avx2_broadcast(value);
+  size_t i = 0;
+  for (; i + lanes <= size; i += lanes) {
+    __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+    unsigned mask = avx2_match_mask<T>(chunk, needle);
+    if (mask != 0) {
+      return i + static_cast<size_t>(__builtin_ctz(mask)) / sizeof(T);
+    }
+  }
+  return i + sse2_find(data + i, size - i, value);
+}
+
+template <typename T>
+__attribute__((target("avx2"))) size_t avx2_count(const T* data, size_t size, const T& value) noexcept {
+  constexpr size_t lanes = 32 / sizeof(T);
+  __m256i needle = avx2_broadcast(value);
+  size_t result = 0;
+  size_t i = 0;
+  for (; i + lanes <= size; i += lanes) {
+    __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+    result += static_cast<size_t>(__builtin_popcount(avx2_match_mask<T>(chunk, needle)));
+  }
+  return result / sizeof(T) + sse2_count(data + i, size - i, value);
+}
+
+inline bool has_avx2() noexcept {
+#ifdef __AVX2__
+  return true;
+#else
+  static const bool supported = __builtin_cpu_supports("avx2");
+  return supported;
+#endif
+}
+
+#endif
+
+template <typename T>
+size_t find_index(const T* data, size_t size, const T& value) {
+#if SOCOW_SIMD_X86
+  if constexpr (simd_searchable<T>) {
+    return has_avx2() ? avx2_find(data, size, value) : sse2_find(data, size, value);
+  }
+#endif
+  return scalar_find(data, size, value);
+}
+
+template <typename T>
+size_t count(const T* data, size_t size, const T& value) {
+#if SOCOW_SIMD_X86
+  if constexpr (simd_searchable<T>) {
+    return has_avx2() ? avx2_count(data, size, value) : sse2_count(data, size, value);
+  }
+#endif
+  return scalar_count(data, size, value);
+}
+
+} // namespace socow_detail
@@ -0,0 +1,253 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+
+#ifndef SOCOW_VECTOR_STATS
+#define SOCOW_VECTOR_STATS 0
+#endif
+
+namespace socow_stats {
+
+inline constexpr size_t SIZE_CLASSES = 16;
+
+inline constexpr size_t size_class(size_t bytes) noexcept {
+  size_t width = bytes <= 1 ? 0 : static_cast<size_t>(std::bit_width(bytes - 1));
+  return width <= 6 ? 0 : std::min(width - 6, SIZE_CLASSES - 1);
+}
+
+struct snapshot {
+  uint64_t small_to_big = 0;
+  uint64_t big_to_small = 0;
+  uint64_t allocations = 0;
+  uint64_t allocated_bytes = 0;
+  std::array<uint64_t, SIZE_CLASSES> allocations_by_size_class{};
+  uint64_t copied_bytes = 0;
+  uint64_t detaches = 0;
+  uint64_t detach_bytes = 0;
+  uint64_t reserve_reallocations = 0;
+  uint64_t max_references = 0;
+
+  snapshot& operator+=(const snapshot& other) noexcept {
+    small_to_big += other.small_to_big;
+    big_to_small += other.big_to_small;
+    allocations += other.allocations;
+    allocated_bytes += other.allocated_bytes;
+    for (size_t i = 0; i < SIZE_CLASSES; ++i) {
+      allocations_by_size_class[i] += other.allocations_by_size_class[i];
+    }
+    copied_bytes += other.copied_bytes;
+    detaches += other.detaches;
+    detach_bytes += other.detach_bytes;
+    reserve_reallocations += other.reserve_reallocations;
+    max_references = std::max(max_references, other.max_references);
+    return *this;
+  }
+};
+
+namespace detail {
+
+class counter {
+public:
+  void add(uint64_t value) noexcept {
+    _value.store(_value.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+  }
+
+  void raise_to(uint64_t value) noexcept {
+    if (value > _value.load(std::memory_order_relaxed)) {
+      _value.store(value, std::memory_order_relaxed);
+    }
+  }
+
+  uint64_t load() const noexcept {
+    return _value.load(std::memory_order_relaxed);
+  }
+
+  void reset() noexcept {
+    _value.store(0, std::memory_order_relaxed);
+  }
+
+private:
+  std::atomic<uint64_t> _value{0};
+};
+
+struct thread_counters;
+
+struct registry {
+  std::mutex mutex;
+  thread_counters* head = nullptr;
+  snapshot retired;
+
+  static registry& instance() {
+    static registry result;
+    return result;
+  }
+};
+
+struct thread_counters {
+  counter small_to_big;
+  counter big_to_small;
+  counter allocations;
+  counter allocated_bytes;
+  std::array<counter, SIZE_CLASSES> allocations_by_size_class;
+  counter copied_bytes;
+  counter detaches;
+  counter detach_bytes;
+  counter reserve_reallocations;
+  counter max_references;
+
+  thread_counters* prev = nullptr;
+  thread_counters* next = nullptr;
+
+  thread_counters() {
+    registry& r = registry::instance();
+    std::lock_guard lock(r.mutex);
+    next = r.head;
+    if (next != nullptr) {
+      next->prev = this;
+    }
+    r.head = this;
+  }
+
+  thread_counters(const thread_counters&) = delete;
+  thread_counters& operator=(const thread_counters&) = delete;
+
+  ~thread_counters() {
+    registry& r = registry::instance();
+    std::lock_guard lock(r.mutex);
+    r.retired += read();
+    if (prev != nullptr) {
+      prev->next = next;
+    } else {
+      r.head = next;
+    }
+    if (next != nullptr) {
+      next->prev = prev;
+    }
+  }
+
+  snapshot read() const noexcept {
+    snapshot result;
+    result.small_to_big = small_to_big.load();
+    result.big_to_small = big_to_small.load();
+    result.allocations = allocations.load();
+    result.allocated_bytes = allocated_bytes.load();
+    for (size_t i = 0; i < SIZE_CLASSES; ++i) {
+      result.allocations_by_size_class[i] = allocations_by_size_class[i].load();
+    }
+    result.copied_bytes = copied_bytes.load();
+    result.detaches = detaches.load();
+    result.detach_bytes = detach_bytes.load();
+    result.reserve_reallocations = reserve_reallocations.load();
+    result.max_references = max_references.load();
+    return result;
+  }
+
+  void reset() noexcept {
+    small_to_big.reset();
+    big_to_small.reset();
+    allocations.reset();
+    allocated_bytes.reset();
+    for (auto& c : allocations_by_size_class) {
+      c.reset();
+    }
+    copied_bytes.reset();
+    detaches.reset();
+    detach_bytes.reset();
+    reserve_reallocations.reset();
+    max_references.reset();
+  }
+
+  static thread_counters& local() {
+    thread_local thread_counters result;
+    return result;
+  }
+};
+
+} // namespace detail
+
+inline constexpr bool enabled = SOCOW_VECTOR_STATS != 0;
+
+inline snapshot thread_stats() {
+  if constexpr (enabled) {
+    return detail::thread_counters::local().read();
+  }
+  return {};
+}
+
+inline snapshot aggregated_stats() {
+  if constexpr (enabled) {
+    detail::registry& r = detail::registry::instance();
+    std::lock_guard lock(r.mutex);
+    snapshot result = r.retired;
+    for (auto* t = r.head; t != nullptr; t = t->next) {
+      result += t->read();
+    }
+    return result;
+  }
+  return {};
+}
+
+inline void reset_thread_stats() {
+  if constexpr (enabled) {
+    detail::thread_counters::local().reset();
+  }
+}
+
+namespace detail {
+
+inline void on_small_to_big() {
+  if constexpr (enabled) {
+    detail::thread_counters::local().small_to_big.add(1);
+  }
+}
+
+inline void on_big_to_small() {
+  if constexpr (enabled) {
+    detail::thread_counters::local().big_to_small.add(1);
+  }
+}
+
+inline void on_allocation(size_t bytes) {
+  if constexpr (enabled) {
+    auto& t = detail::thread_counters::local();
+    t.allocations.add(1);
+    t.allocated_bytes.add(bytes);
+    t.allocations_by_size_class[size_class(bytes)].add(1);
+  }
+}
+
+inline void on_copy(size_t bytes) {
+  if constexpr (enabled) {
+    detail::thread_counters::local().copied_bytes.add(bytes);
+  }
+}
+
+inline void on_detach(size_t bytes) {
+  if constexpr (enabled) {
+    auto& t = detail::thread_counters::local();
+    t.detaches.add(1);
+    t.detach_bytes.add(bytes);
+  }
+}
+
+inline void on_reserve_reallocation() {
+  if constexpr (enabled) {
+    detail::thread_counters::local().reserve_reallocations.add(1);
+  }
+}
+
+inline void on_references(size_t references) {
+  if constexpr (enabled) {
+    detail::thread_counters::local().max_references.raise_to(references);
+  }
+}
+
+} // namespace detail
+
+} // namespace socow_stats
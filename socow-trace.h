@@ -0,0 +1,204 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <ostream>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#ifndef SOCOW_VECTOR_AUDIT_DETACHES
+#define SOCOW_VECTOR_AUDIT_DETACHES 0
+#endif
+
+#ifndef SOCOW_VECTOR_TRACE_DETACHES
+#define SOCOW_VECTOR_TRACE_DETACHES SOCOW_VECTOR_AUDIT_DETACHES
+#endif
+
+#if SOCOW_VECTOR_AUDIT_DETACHES && !SOCOW_VECTOR_TRACE_DETACHES
+#error "SOCOW_VECTOR_AUDIT_DETACHES requires SOCOW_VECTOR_TRACE_DETACHES"
+#endif
+
+#if SOCOW_VECTOR_TRACE_DETACHES
+#include <source_location>
+
+#define SOCOW_TRACE_INDEX socow_trace::index_argument
+#define SOCOW_TRACE_SITE_PARAMETER socow_trace::call_site site = socow_trace::call_site::current()
+#define SOCOW_TRACE_SITE_TRAILING_PARAMETER , SOCOW_TRACE_SITE_PARAMETER
+#define SOCOW_TRACE_SITE site
+#else
+#define SOCOW_TRACE_INDEX size_t
+#define SOCOW_TRACE_SITE_PARAMETER
+#define SOCOW_TRACE_SITE_TRAILING_PARAMETER
+#define SOCOW_TRACE_SITE socow_trace::call_site()
+#endif
+
+namespace socow_trace {
+
+inline constexpr bool enabled = SOCOW_VECTOR_TRACE_DETACHES != 0;
+inline constexpr bool audit_enabled = SOCOW_VECTOR_AUDIT_DETACHES != 0;
+
+#if SOCOW_VECTOR_TRACE_DETACHES
+using call_site = std::source_location;
+
+struct index_argument {
+  size_t value;
+  call_site site;
+
+  index_argument(size_t value, call_site site = call_site::current()) noexcept : value(value), site(site) {}
+};
+
+inline size_t index_value(index_argument index) noexcept {
+  return index.value;
+}
+
+inline call_site index_site(index_argument index) noexcept {
+  return index.site;
+}
+#else
+struct call_site {
+  static constexpr call_site current() noexcept {
+    return {};
+  }
+};
+
+inline size_t index_value(size_t index) noexcept {
+  return index;
+}
+
+inline call_site index_site(size_t) noexcept {
+  return {};
+}
+#endif
+
+struct site_report {
+  std::string_view file;
+  std::string_view function;
+  uint32_t line = 0;
+  uint32_t column = 0;
+  uint64_t detaches = 0;
+  uint64_t bytes = 0;
+  uint64_t wasted_detaches = 0;
+  uint64_t wasted_bytes = 0;
+};
+
+namespace detail {
+
+struct site_key {
+  std::string_view file;
+  uint32_t line;
+  uint32_t column;
+
+  bool operator==(const site_key&) const = default;
+};
+
+struct site_key_hash {
+  size_t operator()(const site_key& key) const noexcept {
+    return std::hash<std::string_view>()(key.file) ^ (static_cast<size_t>(key.line) << 16) ^ key.column;
+  }
+};
+
+struct site_table {
+  std::mutex mutex;
+  std::unordered_map<site_key, site_report, site_key_hash> sites;
+
+  static site_table& instance() {
+    static site_table result;
+    return result;
+  }
+};
+
+#if SOCOW_VECTOR_TRACE_DETACHES
+inline site_report& report_for(site_table& table, call_site site) {
+  site_report& report = table.sites[site_key{site.file_name(), site.line(), site.column()}];
+  if (report.file.empty()) {
+    report.file = site.file_name();
+    report.function = site.function_name();
+    report.line = site.line();
+    report.column = site.column();
+  }
+  return report;
+}
+#endif
+
+inline void on_detach([[maybe_unused]] size_t bytes, [[maybe_unused]] call_site site) {
+#if SOCOW_VECTOR_TRACE_DETACHES
+  site_table& table = site_table::instance();
+  std::lock_guard lock(table.mutex);
+  site_report& report = report_for(table, site);
+  ++report.detaches;
+  report.bytes += bytes;
+#endif
+}
+
+inline void on_wasted_detach([[maybe_unused]] size_t bytes, [[maybe_unused]] call_site site) {
+#if SOCOW_VECTOR_AUDIT_DETACHES
+  site_table& table = site_table::instance();
+  std::lock_guard lock(table.mutex);
+  site_report& report = report_for(table, site);
+  ++report.wasted_detaches;
+  report.wasted_bytes += bytes;
+#endif
+}
+
+struct detach_audit {
+  size_t checksum = 0;
+  size_t size = 0;
+  call_site site;
+  std::atomic<bool> armed{false};
+};
+
+} // namespace detail
+
+inline std::vector<site_report> detach_report() {
+  detail::site_table& table = detail::site_table::instance();
+  std::vector<site_report> result;
+  {
+    std::lock_guard lock(table.mutex);
+    result.reserve(table.sites.size());
+    for (auto& [key, report] : table.sites) {
+      result.push_back(report);
+    }
+  }
+  std::sort(result.begin(), result.end(), [](const site_report& left, const site_report& right) {
+    return left.bytes != right.bytes ? left.bytes > right.bytes : left.detaches > right.detaches;
+  });
+  return result;
+}
+
+inline std::vector<site_report> wasted_detach_report() {
+  std::vector<site_report> result = detach_report();
+  std::erase_if(result, [](const site_report& report) { return report.wasted_detaches == 0; });
+  std::sort(result.begin(), result.end(), [](const site_report& left, const site_report& right) {
+    return left.wasted_bytes != right.wasted_bytes ? left.wasted_bytes > right.wasted_bytes
+                                                   : left.wasted_detaches > right.wasted_detaches;
+  });
+  return result;
+}
+
+inline void reset_detach_report() {
+  detail::site_table& table = detail::site_table::instance();
+  std::lock_guard lock(table.mutex);
+  table.sites.clear();
+}
+
+inline void dump_detach_report(std::ostream& out) {
+  for (const site_report& report : detach_report()) {
+    out << report.file << ':' << report.line << ':' << report.column << ": " << report.detaches << " detaches, "
+        << report.bytes << " bytes copied in " << report.function << '\n';
+  }
+}
+
+inline void dump_wasted_detach_report(std::ostream& out) {
+  for (const site_report& report : wasted_detach_report()) {
+    out << report.file << ':' << report.line << ':' << report.column << ": " << report.wasted_detaches << " of "
+        << report.detaches << " detaches never written, " << report.wasted_bytes << " bytes wasted in "
+        << report.function << '\n';
+  }
+}
+
+} // namespace socow_trace
@@ -1,14 +1,358 @@
 #pragma once
 
+#include "socow-arena.h"
+#include "socow-epoch.h"
+#include "socow-reclaim.h"
+#include "socow-simd.h"
+#include "socow-stats.h"
+#include "socow-trace.h"
+
 #include <algorithm>
 #include <array>
+#include <atomic>
+#include <bit>
 #include <cassert>
+#include <compare>
+#include <concepts>
 #include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iterator>
 #include <memory>
+#include <new>
+#include <string>
+#include <string_view>
+#include <type_traits>
 #include <utility>
+#include <vector>
+
+#ifndef SOCOW_VECTOR_METADATA_CACHE
+#define SOCOW_VECTOR_METADATA_CACHE 0
+#endif
+
+#ifndef SOCOW_VECTOR_ISOLATE_REFCOUNT
+#define SOCOW_VECTOR_ISOLATE_REFCOUNT 0
+#endif
+
+#ifndef SOCOW_VECTOR_CACHE_LINE_SIZE
+#define SOCOW_VECTOR_CACHE_LINE_SIZE 64
+#endif
+
+namespace socow_detail {
+
+template <typename T>
+concept bitwise_comparable = (std::is_arithmetic_v<T> || std::is_enum_v<T> || std::is_pointer_v<T>) &&
+                             std::has_unique_object_representations_v<T>;
+
+template <typename T>
+size_t hash_range(const T* data, size_t size) {
+  if constexpr (bitwise_comparable<T>) {
+    return std::hash<std::string_view>()(std::string_view(reinterpret_cast<const char*>(data), size * sizeof(T)));
+  } else {
+    size_t seed = size;
+    for (size_t i = 0; i < size; ++i) {
+      seed ^= std::hash<T>()(data[i]) + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2);
+    }
+    return seed;
+  }
+}
+
+template <typename T>
+concept hashable = bitwise_comparable<T> || requires(const T& value) {
+  { std::hash<T>()(value) } -> std::convertible_to<size_t>;
+};
+
+class storage_registry {
+public:
+  virtual void forget(void* storage) noexcept = 0;
+
+protected:
+  ~storage_registry() = default;
+};
+
+class external_buffer {
+public:
+  virtual void release(void* elements, size_t length) noexcept = 0;
+
+protected:
+  ~external_buffer() = default;
+};
+
+template <typename T, typename Deleter>
+class adopted_buffer final : public external_buffer {
+public:
+  explicit adopted_buffer(Deleter deleter) : _deleter(std::move(deleter)) {}
+
+  void release(void* elements, size_t length) noexcept override {
+    std::destroy_n(static_cast<T*>(elements), length);
+    _deleter(static_cast<T*>(elements));
+    delete this;
+  }
+
+private:
+  Deleter _deleter;
+};
+
+template <typename T>
+class vector_buffer final : public external_buffer {
+public:
+  explicit vector_buffer(std::vector<T>&& vector) noexcept : _vector(std::move(vector)) {}
+
+  T* data() noexcept {
+    return _vector.data();
+  }
+
+  void release(void*, size_t) noexcept override {
+    delete this;
+  }
+
+private:
+  std::vector<T> _vector;
+};
+
+class pending_copy {
+public:
+  enum : unsigned {
+    QUEUED,
+    RUNNING,
+    DONE,
+    CANCELLED,
+  };
+
+  pending_copy(void* source, size_t size, void (*destroy)(void*, size_t) noexcept) noexcept
+      : _source(source), _size(size), _destroy(destroy) {}
+
+  pending_copy(const pending_copy&) = delete;
+  pending_copy& operator=(const pending_copy&) = delete;
+
+  void* source() const noexcept {
+    return _source;
+  }
+
+  size_t size() const noexcept {
+    return _size;
+  }
+
+  bool start() noexcept {
+    return transition(QUEUED, RUNNING);
+  }
+
+  bool cancel() noexcept {
+    return transition(QUEUED, CANCELLED);
+  }
+
+  void finish(void* result) noexcept {
+    _result = result;
+    _state.store(DONE, std::memory_order_release);
+    _state.notify_all();
+  }
+
+  void* take(size_t size) noexcept {
+    _state.wait(RUNNING, std::memory_order_acquire);
+    if (_state.load(std::memory_order_acquire) != DONE || size != _size) {
+      return nullptr;
+    }
+    return std::exchange(_result, nullptr);
+  }
+
+  void unref() noexcept {
+    if (_references.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      if (_result != nullptr) {
+        _destroy(_result, _size);
+      }
+      delete this;
+    }
+  }
+
+private:
+  bool transition(unsigned from, unsigned to) noexcept {
+    return _state.compare_exchange_strong(from, to, std::memory_order_acq_rel);
+  }
 
-template <typename T, size_t SMALL_SIZE>
+  std::atomic<unsigned> _state{QUEUED};
+  std::atomic<unsigned> _references{2};
+  void* _result = nullptr;
+  void* _source;
+  size_t _size;
+  void (*_destroy)(void*, size_t) noexcept;
+};
+
+class storage_metadata {
+public:
+  enum : unsigned {
+    HASH = 1,
+    SORTED_KNOWN = 2,
+    SORTED = 4,
+    MIN_MAX = 8,
+  };
+
+  template <typename F>
+  size_t hash(F compute) {
+    if (_valid.load(std::memory_order_acquire) & HASH) {
+      return _hash.load(std::memory_order_relaxed);
+    }
+    size_t result = compute();
+    _hash.store(result, std::memory_order_relaxed);
+    _valid.fetch_or(HASH, std::memory_order_release);
+    return result;
+  }
+
+  template <typename F>
+  bool is_sorted(F compute) {
+    unsigned valid = _valid.load(std::memory_order_acquire);
+    if (valid & SORTED_KNOWN) {
+      return valid & SORTED;
+    }
+    bool result = compute();
+    unsigned known = SORTED_KNOWN;
+    if (result) {
+      known |= SORTED;
+    }
+    _valid.fetch_or(known, std::memory_order_release);
+    return result;
+  }
+
+  template <typename F>
+  std::pair<size_t, size_t> min_max(F compute) {
+    if (_valid.load(std::memory_order_acquire) & MIN_MAX) {
+      return {_min_index.load(std::memory_order_relaxed), _max_index.load(std::memory_order_relaxed)};
+    }
+    std::pair<size_t, size_t> result = compute();
+    _min_index.store(result.first, std::memory_order_relaxed);
+    _max_index.store(result.second, std::memory_order_relaxed);
+    _valid.fetch_or(MIN_MAX, std::memory_order_release);
+    return result;
+  }
+
+  void invalidate() noexcept {
+    if (_valid.load(std::memory_order_relaxed) != 0) {
+      _valid.store(0, std::memory_order_relaxed);
+    }
+  }
+
+private:
+  std::atomic<unsigned> _valid{0};
+  std::atomic<size_t> _hash{0};
+  std::atomic<size_t> _min_index{0};
+  std::atomic<size_t> _max_index{0};
+};
+
+struct storage_access;
+
+inline uint64_t next_storage_version() noexcept {
+  static std::atomic<uint64_t> counter{0};
+  return counter.fetch_add(1, std::memory_order_relaxed) + 1;
+}
+
+} // namespace socow_detail
+
+struct socow_storage_token {
+  const void* storage = nullptr;
+  uint64_t version = 0;
+  size_t size = 0;
+
+  friend bool operator==(const socow_storage_token& left, const socow_storage_token& right) noexcept {
+    return (left.storage != nullptr || left.size == 0) && left.storage == right.storage &&
+           left.version == right.version && left.size == right.size;
+  }
+};
+
+struct socow_memory_usage {
+  size_t inline_bytes = 0;
+  size_t heap_bytes = 0;
+  size_t exclusive_bytes = 0;
+  size_t proportional_bytes = 0;
+
+  socow_memory_usage& operator+=(const socow_memory_usage& other) noexcept {
+    inline_bytes += other.inline_bytes;
+    heap_bytes += other.heap_bytes;
+    exclusive_bytes += other.exclusive_bytes;
+    proportional_bytes += other.proportional_bytes;
+    return *this;
+  }
+
+  friend socow_memory_usage operator+(socow_memory_usage left, const socow_memory_usage& right) noexcept {
+    return left += right;
+  }
+};
+
+template <typename T>
+struct socow_memory_traits {
+  static constexpr bool HAS_HEAP = false;
+
+  static socow_memory_usage usage(const T&) noexcept {
+    return {sizeof(T), 0, 0, 0};
+  }
+};
+
+template <typename T>
+socow_memory_usage socow_memory_usage_of(const T& value) {
+  return socow_memory_traits<T>::usage(value);
+}
+
+template <typename Iterator>
+socow_memory_usage socow_memory_usage_of(Iterator first, Iterator last) {
+  socow_memory_usage result;
+  for (; first != last; ++first) {
+    result += socow_memory_usage_of(*first);
+  }
+  return result;
+}
+
+namespace socow_detail {
+
+template <typename T>
+socow_memory_usage element_heap_usage(const T* data, size_t size) {
+  socow_memory_usage result;
+  if constexpr (socow_memory_traits<T>::HAS_HEAP) {
+    result = socow_memory_usage_of(data, data + size);
+    result.inline_bytes = 0;
+  }
+  return result;
+}
+
+} // namespace socow_detail
+
+template <typename CharT, typename Traits, typename Allocator>
+struct socow_memory_traits<std::basic_string<CharT, Traits, Allocator>> {
+  static constexpr bool HAS_HEAP = true;
+
+  static socow_memory_usage usage(const std::basic_string<CharT, Traits, Allocator>& string) noexcept {
+    auto object = reinterpret_cast<uintptr_t>(&string);
+    auto data = reinterpret_cast<uintptr_t>(string.data());
+    if (data >= object && data < object + sizeof(string)) {
+      return {sizeof(string), 0, 0, 0};
+    }
+    size_t heap = (string.capacity() + 1) * sizeof(CharT);
+    return {sizeof(string), heap, heap, heap};
+  }
+};
+
+template <typename T, typename Allocator>
+struct socow_memory_traits<std::vector<T, Allocator>> {
+  static constexpr bool HAS_HEAP = true;
+
+  static socow_memory_usage usage(const std::vector<T, Allocator>& vector) {
+    socow_memory_usage result = socow_detail::element_heap_usage(vector.data(), vector.size());
+    size_t heap = vector.capacity() * sizeof(T);
+    return {sizeof(vector), result.heap_bytes + heap, result.exclusive_bytes + heap, result.proportional_bytes + heap};
+  }
+};
+
+template <typename T, size_t SMALL_SIZE, size_t ALIGNMENT = alignof(T)>
+class socow_intern_table;
+
+template <typename T, size_t SMALL_SIZE, size_t ALIGNMENT = alignof(T)>
 class socow_vector {
+  friend class socow_intern_table<T, SMALL_SIZE, ALIGNMENT>;
+  friend struct socow_detail::storage_access;
+
+  static_assert(std::has_single_bit(ALIGNMENT) && ALIGNMENT >= alignof(T));
+
+  static constexpr size_t DATA_ALIGNMENT =
+      SOCOW_VECTOR_ISOLATE_REFCOUNT ? std::max<size_t>(ALIGNMENT, SOCOW_VECTOR_CACHE_LINE_SIZE) : ALIGNMENT;
+
 public:
   using value_type = T;
 
@@ -21,31 +365,143 @@ public:
   using iterator = pointer;
   using const_iterator = const_pointer;
 
+  using call_site = socow_trace::call_site;
+
+  struct released_buffer {
+    pointer data;
+    size_t size;
+    size_t capacity;
+    void* context;
+    void (*deallocate)(void* context, size_t size) noexcept;
+  };
+
 private:
   struct dynamic_storage {
     size_t _capacity;
-    size_t _references;
-    T _data[0];
+    std::atomic<size_t> _references;
+#if SOCOW_VECTOR_METADATA_CACHE
+    socow_detail::storage_metadata _metadata;
+#endif
+    std::atomic<socow_detail::storage_registry*> _registry{nullptr};
+    std::atomic<socow_detail::pending_copy*> _pending{nullptr};
+    std::atomic<uint64_t> _version{0};
+    ptrdiff_t _arena_distance = 0;
+    ptrdiff_t _elements_distance;
+    socow_detail::external_buffer* _external = nullptr;
+    bool _read_only = false;
+#if SOCOW_VECTOR_AUDIT_DETACHES
+    socow_trace::detail::detach_audit _audit;
+#endif
+    alignas(DATA_ALIGNMENT) T _data[0];
 
-    dynamic_storage(size_t capacity) : _capacity(capacity), _references(1) {}
+    dynamic_storage(size_t capacity)
+        : _capacity(capacity), _references(1),
+          _elements_distance(reinterpret_cast<char*>(_data) - reinterpret_cast<char*>(this)) {}
 
     dynamic_storage(const dynamic_storage& other) = default;
 
     void inc_references() noexcept {
-      ++_references;
+      inc_handle_references();
+      if (_arena_distance != 0) {
+        socow_detail::arena_mappings::retain(arena());
+      }
+    }
+
+    void inc_handle_references() noexcept {
+      size_t references = _references.fetch_add(1, std::memory_order_relaxed) + 1;
+      socow_stats::detail::on_references(references);
+    }
+
+    bool try_inc_references() noexcept {
+      size_t references = _references.load(std::memory_order_relaxed);
+      while (references != 0) {
+        if (_references.compare_exchange_weak(references, references + 1, std::memory_order_relaxed)) {
+          socow_stats::detail::on_references(references + 1);
+          if (_arena_distance != 0) {
+            socow_detail::arena_mappings::retain(arena());
+          }
+          return true;
+        }
+      }
+      return false;
     }
 
-    void dec_references() noexcept {
+    size_t dec_references() noexcept {
       assert(references() > 0);
-      --_references;
+      size_t references = _references.fetch_sub(1, std::memory_order_acq_rel) - 1;
+      if (references == 1 && _pending.load(std::memory_order_relaxed) != nullptr) {
+        discard_pending();
+      }
+      return references;
+    }
+
+    void discard_pending() noexcept {
+      if (auto* pending = _pending.exchange(nullptr, std::memory_order_acquire)) {
+        pending->unref();
+      }
     }
 
     size_t capacity() const noexcept {
       return _capacity;
     }
 
+    T* elements() noexcept {
+      return reinterpret_cast<T*>(reinterpret_cast<uintptr_t>(this) + _elements_distance);
+    }
+
+    const T* elements() const noexcept {
+      return reinterpret_cast<const T*>(reinterpret_cast<uintptr_t>(this) + _elements_distance);
+    }
+
+    void point_to(T* external_elements) noexcept {
+      _elements_distance =
+          static_cast<ptrdiff_t>(reinterpret_cast<uintptr_t>(external_elements) - reinterpret_cast<uintptr_t>(this));
+    }
+
+    bool shared() const noexcept {
+      return _read_only || references() > 1;
+    }
+
     size_t references() const noexcept {
-      return _references;
+      return _references.load(std::memory_order_acquire);
+    }
+
+    socow_detail::shared_arena* arena() noexcept {
+      if (_arena_distance == 0) {
+        return nullptr;
+      }
+      return reinterpret_cast<socow_detail::shared_arena*>(reinterpret_cast<char*>(this) - _arena_distance);
+    }
+
+    bool registered() const noexcept {
+      return _registry.load(std::memory_order_acquire) != nullptr;
+    }
+
+    void forget_registry() noexcept {
+      if (auto* registry = _registry.exchange(nullptr, std::memory_order_acq_rel)) {
+        registry->forget(this);
+      }
+    }
+
+    uint64_t version() noexcept {
+      uint64_t current = _version.load(std::memory_order_acquire);
+      if (current != 0) {
+        return current;
+      }
+      uint64_t fresh = socow_detail::next_storage_version();
+      if (_version.compare_exchange_strong(current, fresh, std::memory_order_acq_rel)) {
+        return fresh;
+      }
+      return current;
+    }
+
+    void on_mutation() noexcept {
+#if SOCOW_VECTOR_METADATA_CACHE
+      _metadata.invalidate();
+#endif
+      if (_version.load(std::memory_order_relaxed) != 0) {
+        _version.store(0, std::memory_order_relaxed);
+      }
     }
   };
 
@@ -54,7 +510,7 @@ private:
   bool _is_small;
 
   union {
-    T _static_data[SMALL_SIZE];
+    alignas(ALIGNMENT) T _static_data[SMALL_SIZE];
     dynamic_storage* _dynamic_data;
   };
 
@@ -72,39 +528,146 @@ private:
   }
 
   static void dec_references(dynamic_storage* data, size_t length) {
-    data->dec_references();
-    if (data->references() == 0) {
-      std::destroy_n(data->_data, length);
+    if (auto* arena = data->arena()) {
+      if (data->dec_references() == 0) {
+        audit_detach(data, length);
+        data->forget_registry();
+        destroy_storage(data, length);
+      }
+      socow_detail::arena_mappings::release(arena);
+      return;
+    }
+    if (data->dec_references() == 0) {
+      audit_detach(data, length);
+      data->forget_registry();
+#if SOCOW_VECTOR_EPOCH_RECLAMATION
+      socow_detail::epoch_domain::instance().retire(data, length,
+                                                    sizeof(dynamic_storage) + sizeof(T) * data->capacity(),
+                                                    &destroy_storage);
+      return;
+#endif
+#if SOCOW_VECTOR_ASYNC_RECLAMATION
+      if (data->capacity() * sizeof(T) >= socow_detail::background_worker::RECLAIM_THRESHOLD &&
+          socow_detail::background_worker::post(data, length, &destroy_storage)) {
+        return;
+      }
+#endif
+      destroy_storage(data, length);
+    }
+  }
+
+  static void destroy_storage(void* pointer, size_t length) noexcept {
+    auto* data = static_cast<dynamic_storage*>(pointer);
+    if (auto* pending = data->_pending.load(std::memory_order_acquire)) {
+      pending->unref();
+    }
+    if (data->_external != nullptr) {
+      data->_external->release(data->elements(), length);
+    } else {
+      std::destroy_n(data->elements(), length);
+    }
+    deallocate_storage(data);
+  }
+
+  static void destroy_released_storage(void* pointer, size_t length) noexcept {
+    auto* arena = static_cast<dynamic_storage*>(pointer)->arena();
+    destroy_storage(pointer, length);
+    if (arena != nullptr) {
+      socow_detail::arena_mappings::release(arena);
+    }
+  }
+
+  static constexpr bool OVER_ALIGNED_STORAGE = alignof(dynamic_storage) > __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+
+  static void deallocate_storage(dynamic_storage* data) noexcept {
+    if (auto* arena = data->arena()) {
+      arena->deallocate(data);
+    } else if constexpr (OVER_ALIGNED_STORAGE) {
+      operator delete(data, std::align_val_t(alignof(dynamic_storage)));
+    } else {
       operator delete(data);
     }
   }
 
   static dynamic_storage* get_new_empty_storage(size_t capacity) {
-    auto* data_pointer = operator new(sizeof(dynamic_storage) + sizeof(T) * capacity);
+    size_t bytes = sizeof(dynamic_storage) + sizeof(T) * capacity;
+    void* data_pointer;
+    if constexpr (OVER_ALIGNED_STORAGE) {
+      data_pointer = operator new(bytes, std::align_val_t(alignof(dynamic_storage)));
+    } else {
+      data_pointer = operator new(bytes);
+    }
+    socow_stats::detail::on_allocation(bytes);
     auto* new_dynamic_data = new (data_pointer) dynamic_storage(capacity);
     return new_dynamic_data;
   }
 
-  dynamic_storage* get_copied_storage(const_pointer from, size_t size, size_t capacity) {
+  static dynamic_storage* get_copied_storage(const_pointer from, size_t size, size_t capacity) {
     assert(capacity >= size);
     auto* new_dynamic_data = get_new_empty_storage(capacity);
     try {
       std::uninitialized_copy_n(from, size, new_dynamic_data->_data);
     } catch (...) {
-      operator delete(new_dynamic_data);
+      deallocate_storage(new_dynamic_data);
       throw;
     }
+    socow_stats::detail::on_copy(size * sizeof(T));
 
     return new_dynamic_data;
   }
 
-  dynamic_storage* get_copied_storage(size_t capacity) {
+  void relocate_to(pointer to, size_t gap = SIZE_MAX) {
+    pointer from = is_small() ? _static_data : _dynamic_data->elements();
+    size_t head = std::min(gap, size());
+    if constexpr (std::is_nothrow_move_constructible_v<T>) {
+      if (!copied() && !is_small() && _dynamic_data->registered()) {
+        _dynamic_data->forget_registry();
+      }
+      if (!copied()) {
+        std::uninitialized_move_n(from, head, to);
+        std::uninitialized_move_n(from + head, size() - head, to + head + 1);
+        socow_stats::detail::on_copy(size() * sizeof(T));
+        return;
+      }
+    }
+    std::uninitialized_copy_n(std::as_const(from), head, to);
+    try {
+      std::uninitialized_copy_n(std::as_const(from) + head, size() - head, to + head + 1);
+    } catch (...) {
+      std::destroy_n(to, head);
+      throw;
+    }
+    socow_stats::detail::on_copy(size() * sizeof(T));
+  }
+
+  dynamic_storage* get_relocated_storage(size_t capacity) {
     assert(capacity >= size());
-    return get_copied_storage(std::as_const(*this).data(), size(), capacity);
+    auto* new_dynamic_data = get_new_empty_storage(capacity);
+    try {
+      relocate_to(new_dynamic_data->_data);
+    } catch (...) {
+      deallocate_storage(new_dynamic_data);
+      throw;
+    }
+    return new_dynamic_data;
+  }
+
+  void note_detach(size_t length, call_site site) {
+    socow_stats::detail::on_detach(length * sizeof(T));
+    socow_trace::detail::on_detach(length * sizeof(T), site);
+  }
+
+  void note_reallocation(call_site site) {
+    if (is_small()) {
+      socow_stats::detail::on_small_to_big();
+    } else if (copied()) {
+      note_detach(size(), site);
+    }
   }
 
-  void copy_on_write(size_t capacity) {
-    auto* new_dynamic_data = get_copied_storage(capacity);
+  void copy_on_write(size_t capacity, call_site site) {
+    note_reallocation(site);
+    auto* new_dynamic_data = get_relocated_storage(capacity);
     dec_references();
     _is_small = false;
     _dynamic_data = new_dynamic_data;
@@ -114,12 +677,137 @@ private:
     if (is_small()) {
       return false;
     }
-    return _dynamic_data->references() > 1;
+    return _dynamic_data->shared();
   }
 
-  void check_cow() {
-    if (copied()) {
-      copy_on_write(capacity());
+  void check_cow(call_site site) {
+    if (copied() && !adopt_prepared_copy(site) && copied()) {
+      copy_on_write(capacity(), site);
+      arm_detach_audit(site);
+    }
+  }
+
+  template <typename U>
+  void assign_at(size_t index, U&& value, call_site site) {
+    if (!copied()) {
+      mutable_data(site)[index] = std::forward<U>(value);
+      return;
+    }
+    dynamic_storage* source = _dynamic_data;
+    size_t length = size();
+    source->inc_references();
+    try {
+      mutable_data(site)[index] = std::forward<U>(value);
+    } catch (...) {
+      dec_references(source, length);
+      throw;
+    }
+    dec_references(source, length);
+  }
+
+  struct detach_task {
+    socow_detail::pending_copy* pending;
+    dynamic_storage* source;
+    size_t size;
+
+    void operator()() const noexcept {
+      if (pending->start()) {
+        dynamic_storage* result = nullptr;
+        try {
+          result = get_copied_storage(source->elements(), size, source->capacity());
+        } catch (...) {
+        }
+        pending->finish(result);
+        dec_references(source, size);
+      }
+      pending->unref();
+    }
+  };
+
+  static void run_detach_task(void* pointer, size_t) noexcept {
+    auto* pending = static_cast<socow_detail::pending_copy*>(pointer);
+    detach_task{pending, static_cast<dynamic_storage*>(pending->source()), pending->size()}();
+  }
+
+  socow_detail::pending_copy* arm_prepared_copy() {
+    if (!copied() || _dynamic_data->arena() != nullptr) {
+      return nullptr;
+    }
+    dynamic_storage* source = _dynamic_data;
+    auto* pending = new socow_detail::pending_copy(source, size(), &destroy_storage);
+    source->inc_references();
+    socow_detail::pending_copy* expected = nullptr;
+    if (!source->_pending.compare_exchange_strong(expected, pending, std::memory_order_acq_rel)) {
+      source->dec_references();
+      delete pending;
+      return nullptr;
+    }
+    return pending;
+  }
+
+  static void abandon_prepared_copy(socow_detail::pending_copy* pending) noexcept {
+    if (pending->cancel()) {
+      static_cast<dynamic_storage*>(pending->source())->dec_references();
+      pending->unref();
+    }
+  }
+
+  bool adopt_prepared_copy(call_site site) {
+    if (_dynamic_data->_pending.load(std::memory_order_relaxed) == nullptr) {
+      return false;
+    }
+    auto* pending = _dynamic_data->_pending.exchange(nullptr, std::memory_order_acq_rel);
+    if (pending == nullptr) {
+      return false;
+    }
+    if (pending->cancel()) {
+      _dynamic_data->dec_references();
+      pending->unref();
+      return false;
+    }
+    auto* copy = static_cast<dynamic_storage*>(pending->take(size()));
+    pending->unref();
+    if (copy == nullptr) {
+      return false;
+    }
+    note_detach(size(), site);
+    dec_references();
+    _dynamic_data = copy;
+    arm_detach_audit(site);
+    return true;
+  }
+
+  void arm_detach_audit([[maybe_unused]] call_site site) {
+#if SOCOW_VECTOR_AUDIT_DETACHES
+    if constexpr (socow_detail::hashable<T>) {
+      auto& audit = _dynamic_data->_audit;
+      audit.checksum = socow_detail::hash_range(_dynamic_data->elements(), size());
+      audit.size = size();
+      audit.site = site;
+      audit.armed.store(true, std::memory_order_release);
+    }
+#endif
+  }
+
+  static void audit_detach([[maybe_unused]] dynamic_storage* data, [[maybe_unused]] size_t length) {
+#if SOCOW_VECTOR_AUDIT_DETACHES
+    if constexpr (socow_detail::hashable<T>) {
+      auto& audit = data->_audit;
+      if (!audit.armed.exchange(false, std::memory_order_acq_rel)) {
+        return;
+      }
+      if (audit.size == length && socow_detail::hash_range(data->elements(), length) == audit.checksum) {
+        socow_trace::detail::on_wasted_detach(length * sizeof(T), audit.site);
+      }
+    }
+#endif
+  }
+
+  struct with_capacity_t {};
+
+  socow_vector(with_capacity_t, size_t capacity) : _size(0), _is_small(capacity <= SMALL_SIZE) {
+    if (!is_small()) {
+      _dynamic_data = get_new_empty_storage(capacity);
     }
   }
 
@@ -129,11 +817,86 @@ private:
     _dynamic_data = get_copied_storage(other.data(), size, capacity);
   }
 
+  static socow_vector from_external(pointer elements, size_t size, size_t capacity,
+                                    socow_detail::external_buffer* owner, bool read_only) {
+    dynamic_storage* storage;
+    try {
+      storage = get_new_empty_storage(0);
+    } catch (...) {
+      owner->release(elements, size);
+      throw;
+    }
+    storage->point_to(elements);
+    storage->_capacity = capacity;
+    storage->_external = owner;
+    storage->_read_only = read_only;
+    socow_vector result;
+    result._is_small = false;
+    result._dynamic_data = storage;
+    result._size = size;
+    return result;
+  }
+
+  template <typename Source>
+  static socow_vector moved_from(Source* elements, size_t size) {
+    socow_vector result(with_capacity_t(), size);
+    for (size_t i = 0; i < size; ++i) {
+      result.push_back(std::move(elements[i]));
+    }
+    return result;
+  }
+
 public:
   socow_vector() noexcept : _size(0), _is_small(true), _dynamic_data(nullptr) {}
 
-  socow_vector(const socow_vector& other) : _size(0), _is_small(true) {
-    *this = other;
+  template <typename Deleter>
+  static socow_vector adopt(pointer elements, size_t size, size_t capacity, Deleter deleter) {
+    assert(size <= capacity);
+    auto release = [&] {
+      std::destroy_n(elements, size);
+      deleter(elements);
+    };
+    if (capacity <= SMALL_SIZE || reinterpret_cast<uintptr_t>(elements) % ALIGNMENT != 0) {
+      try {
+        socow_vector result = moved_from(elements, size);
+        release();
+        return result;
+      } catch (...) {
+        release();
+        throw;
+      }
+    }
+    socow_detail::external_buffer* owner;
+    try {
+      owner = new socow_detail::adopted_buffer<T, Deleter>(deleter);
+    } catch (...) {
+      release();
+      throw;
+    }
+    return from_external(elements, size, capacity, owner, false);
+  }
+
+  static socow_vector from_std_vector(std::vector<T>&& vector) {
+    constexpr bool writable = std::is_trivially_copyable_v<T>;
+    size_t size = vector.size();
+    size_t capacity = writable ? vector.capacity() : size;
+    if (capacity <= SMALL_SIZE || reinterpret_cast<uintptr_t>(vector.data()) % ALIGNMENT != 0) {
+      std::vector<T> source(std::move(vector));
+      return moved_from(source.data(), size);
+    }
+    auto* owner = new socow_detail::vector_buffer<T>(std::move(vector));
+    return from_external(owner->data(), size, capacity, owner, !writable);
+  }
+
+  socow_vector(const socow_vector& other) : _size(0), _is_small(other.is_small()) {
+    if (other.is_small()) {
+      std::uninitialized_copy_n(other._static_data, other.size(), _static_data);
+    } else {
+      audit_detach(other._dynamic_data, other.size());
+      _dynamic_data = other._dynamic_data;
+      _dynamic_data->inc_references();
+    }
+    _size = other.size();
   }
 
   socow_vector& operator=(const socow_vector& other) {
@@ -166,6 +929,7 @@ public:
       }
       dec_references(_data_ptr, size());
     } else {
+      audit_detach(other._dynamic_data, other.size());
       dec_references();
       _dynamic_data = other._dynamic_data;
       _dynamic_data->inc_references();
@@ -181,38 +945,49 @@ public:
     dec_references();
   }
 
-  reference operator[](size_t index) {
-    assert(index < size());
-    return data()[index];
+  reference operator[](SOCOW_TRACE_INDEX index) {
+    assert(socow_trace::index_value(index) < size());
+    return mutable_data(socow_trace::index_site(index))[socow_trace::index_value(index)];
   }
 
-  const_reference operator[](size_t index) const {
-    assert(index < size());
-    return data()[index];
+  const_reference operator[](SOCOW_TRACE_INDEX index) const {
+    assert(socow_trace::index_value(index) < size());
+    return data()[socow_trace::index_value(index)];
   }
 
-  pointer data() {
+  pointer data(SOCOW_TRACE_SITE_PARAMETER) {
+    return mutable_data(SOCOW_TRACE_SITE);
+  }
+
+  const_pointer data() const noexcept {
     if (is_small()) {
       return _static_data;
     }
-    check_cow();
-    return _dynamic_data->_data;
+    return std::assume_aligned<ALIGNMENT>(_dynamic_data->elements());
   }
 
-  const_pointer data() const noexcept {
+private:
+  pointer mutable_data(call_site site) {
     if (is_small()) {
       return _static_data;
     }
-    return _dynamic_data->_data;
+    check_cow(site);
+    if (_dynamic_data->registered()) {
+      _dynamic_data->forget_registry();
+      check_cow(site);
+    }
+    _dynamic_data->on_mutation();
+    return std::assume_aligned<ALIGNMENT>(_dynamic_data->elements());
   }
 
+public:
   size_t size() const noexcept {
     return _size;
   }
 
-  reference front() {
+  reference front(SOCOW_TRACE_SITE_PARAMETER) {
     assert(size() > 0);
-    return (*this)[0];
+    return mutable_data(SOCOW_TRACE_SITE)[0];
   }
 
   const_reference front() const {
@@ -220,9 +995,9 @@ public:
     return (*this)[0];
   }
 
-  reference back() {
+  reference back(SOCOW_TRACE_SITE_PARAMETER) {
     assert(size() > 0);
-    return (*this)[size() - 1];
+    return mutable_data(SOCOW_TRACE_SITE)[size() - 1];
   }
 
   const_reference back() const {
@@ -230,27 +1005,62 @@ public:
     return (*this)[size() - 1];
   }
 
-  void push_back(const T& value) {
+  void push_back(const T& value SOCOW_TRACE_SITE_TRAILING_PARAMETER) {
+    append(SOCOW_TRACE_SITE, value);
+  }
+
+  void push_back(T&& value SOCOW_TRACE_SITE_TRAILING_PARAMETER) {
+    append(SOCOW_TRACE_SITE, std::move(value));
+  }
+
+private:
+  template <typename U>
+  void append(call_site site, U&& value) {
+    if (copied()) {
+      adopt_prepared_copy(site);
+    }
     if (size() == capacity() || copied()) {
-      socow_vector new_vector(*this, size(), capacity() * 2);
-      new_vector.push_back(value);
-      *this = new_vector;
+      note_reallocation(site);
+      auto* new_dynamic_data = get_new_empty_storage(size() == capacity() ? capacity() * 2 : capacity());
+      try {
+        new (new_dynamic_data->_data + size()) T(std::forward<U>(value));
+      } catch (...) {
+        deallocate_storage(new_dynamic_data);
+        throw;
+      }
+      try {
+        relocate_to(new_dynamic_data->_data);
+      } catch (...) {
+        new_dynamic_data->_data[size()].~T();
+        deallocate_storage(new_dynamic_data);
+        throw;
+      }
+      dec_references();
+      _is_small = false;
+      _dynamic_data = new_dynamic_data;
+      ++_size;
       return;
     }
 
-    new (data() + size()) T(value);
+    new (mutable_data(site) + size()) T(std::forward<U>(value));
     ++_size;
   }
 
-  void pop_back() {
+public:
+
+  void pop_back(SOCOW_TRACE_SITE_PARAMETER) {
     assert(size() > 0);
     if (copied()) {
+      adopt_prepared_copy(SOCOW_TRACE_SITE);
+    }
+    if (copied()) {
+      note_detach(size() - 1, SOCOW_TRACE_SITE);
       socow_vector new_vector(*this, size() - 1, capacity());
       swap(new_vector);
       return;
     }
 
-    data()[size() - 1].~T();
+    mutable_data(SOCOW_TRACE_SITE)[size() - 1].~T();
     --_size;
   }
 
@@ -267,34 +1077,35 @@ private:
     dynamic_storage* _data_ptr = _dynamic_data;
     _dynamic_data = nullptr;
     try {
-      std::uninitialized_copy_n(_data_ptr->_data, size(), _static_data);
+      std::uninitialized_copy_n(_data_ptr->elements(), size(), _static_data);
     } catch (...) {
       _dynamic_data = _data_ptr;
       throw;
     }
     dec_references(_data_ptr, size());
     _is_small = true;
+    socow_stats::detail::on_big_to_small();
   }
 
 public:
-  void reserve(size_t new_capacity) {
+  void reserve(size_t new_capacity SOCOW_TRACE_SITE_TRAILING_PARAMETER) {
     if (size() > new_capacity) {
       return;
     }
     if (is_small() && new_capacity <= SMALL_SIZE) {
       return;
     }
-    if (!is_small() && _dynamic_data->references() > 1 && new_capacity <= SMALL_SIZE) {
+    if (!is_small() && _dynamic_data->shared() && new_capacity <= SMALL_SIZE) {
       shrink_big_to_small();
       return;
     }
-    if (is_small() || _dynamic_data->references() > 1 ||
-        (_dynamic_data->references() == 1 && new_capacity > capacity())) {
-      copy_on_write(new_capacity);
+    if (is_small() || _dynamic_data->shared() || new_capacity > capacity()) {
+      socow_stats::detail::on_reserve_reallocation();
+      copy_on_write(new_capacity, SOCOW_TRACE_SITE);
     }
   }
 
-  void shrink_to_fit() {
+  void shrink_to_fit(SOCOW_TRACE_SITE_PARAMETER) {
     if (size() == capacity() || is_small()) {
       return;
     }
@@ -302,15 +1113,51 @@ public:
       shrink_big_to_small();
       return;
     }
-    copy_on_write(size());
+    copy_on_write(size(), SOCOW_TRACE_SITE);
+  }
+
+  template <typename Executor>
+  bool detach_async(Executor&& executor) {
+    auto* pending = arm_prepared_copy();
+    if (pending == nullptr) {
+      return false;
+    }
+    try {
+      std::forward<Executor>(executor)(detach_task{pending, _dynamic_data, size()});
+    } catch (...) {
+      abandon_prepared_copy(pending);
+      throw;
+    }
+    return true;
+  }
+
+  bool prepare_write() {
+    auto* pending = arm_prepared_copy();
+    if (pending == nullptr) {
+      return false;
+    }
+    if (!socow_detail::background_worker::post(pending, size(), &run_detach_task)) {
+      abandon_prepared_copy(pending);
+      return false;
+    }
+    return true;
+  }
+
+  released_buffer release(SOCOW_TRACE_SITE_PARAMETER) {
+    if (is_small()) {
+      copy_on_write(SMALL_SIZE, SOCOW_TRACE_SITE);
+    }
+    pointer elements = mutable_data(SOCOW_TRACE_SITE);
+    released_buffer result{elements, size(), capacity(), _dynamic_data, &destroy_released_storage};
+    _is_small = true;
+    _size = 0;
+    return result;
   }
 
   void clear() {
-    if (is_small() || _dynamic_data->references() == 1) {
-      size_t counter = size();
-      for (size_t i = 0; i < counter; ++i) {
-        pop_back();
-      }
+    if (is_small() || !_dynamic_data->shared()) {
+      std::destroy_n(data(), size());
+      _size = 0;
       return;
     }
     dec_references();
@@ -356,12 +1203,12 @@ public:
     std::swap(_is_small, other._is_small);
   }
 
-  iterator begin() noexcept {
-    return data();
+  iterator begin(SOCOW_TRACE_SITE_PARAMETER) noexcept {
+    return mutable_data(SOCOW_TRACE_SITE);
   }
 
-  iterator end() noexcept {
-    return data() + size();
+  iterator end(SOCOW_TRACE_SITE_PARAMETER) noexcept {
+    return mutable_data(SOCOW_TRACE_SITE) + size();
   }
 
   const_iterator begin() const noexcept {
@@ -372,57 +1219,436 @@ public:
     return data() + size();
   }
 
-  iterator insert(const_iterator pos, const T& value) {
+  class cow_reference {
+  public:
+    cow_reference(socow_vector* vector, size_t index, call_site site) noexcept
+        : _vector(vector), _index(index), _site(site) {}
+
+    cow_reference(const cow_reference& other) = default;
+
+    operator const_reference() const noexcept {
+      return get();
+    }
+
+    const_reference get() const noexcept {
+      return std::as_const(*_vector).data()[_index];
+    }
+
+    reference get_mutable(SOCOW_TRACE_SITE_PARAMETER) {
+      return _vector->mutable_data(SOCOW_TRACE_SITE)[_index];
+    }
+
+    cow_reference& operator=(const T& value) {
+      _vector->assign_at(_index, value, _site);
+      return *this;
+    }
+
+    cow_reference& operator=(T&& value) {
+      _vector->assign_at(_index, std::move(value), _site);
+      return *this;
+    }
+
+    cow_reference& operator=(const cow_reference& other) {
+      if (_vector != other._vector || _index != other._index) {
+        _vector->assign_at(_index, other.get(), _site);
+      }
+      return *this;
+    }
+
+  private:
+    socow_vector* _vector;
+    size_t _index;
+    [[no_unique_address]] call_site _site;
+  };
+
+  class cow_iterator {
+  public:
+    using iterator_category = std::input_iterator_tag;
+    using value_type = T;
+    using difference_type = ptrdiff_t;
+    using reference = cow_reference;
+    using pointer = const_pointer;
+
+    cow_iterator() noexcept = default;
+
+    cow_iterator(socow_vector* vector, size_t index, call_site site) noexcept
+        : _vector(vector), _index(index), _site(site) {}
+
+    cow_reference operator*() const noexcept {
+      return cow_reference(_vector, _index, _site);
+    }
+
+    const_pointer operator->() const noexcept {
+      return std::as_const(*_vector).data() + _index;
+    }
+
+    cow_reference operator[](difference_type offset) const noexcept {
+      return cow_reference(_vector, _index + offset, _site);
+    }
+
+    cow_iterator& operator++() noexcept {
+      ++_index;
+      return *this;
+    }
+
+    cow_iterator operator++(int) noexcept {
+      cow_iterator result = *this;
+      ++_index;
+      return result;
+    }
+
+    cow_iterator& operator--() noexcept {
+      --_index;
+      return *this;
+    }
+
+    cow_iterator operator--(int) noexcept {
+      cow_iterator result = *this;
+      --_index;
+      return result;
+    }
+
+    cow_iterator& operator+=(difference_type offset) noexcept {
+      _index += offset;
+      return *this;
+    }
+
+    cow_iterator& operator-=(difference_type offset) noexcept {
+      _index -= offset;
+      return *this;
+    }
+
+    friend cow_iterator operator+(cow_iterator it, difference_type offset) noexcept {
+      return it += offset;
+    }
+
+    friend cow_iterator operator+(difference_type offset, cow_iterator it) noexcept {
+      return it += offset;
+    }
+
+    friend cow_iterator operator-(cow_iterator it, difference_type offset) noexcept {
+      return it -= offset;
+    }
+
+    friend difference_type operator-(const cow_iterator& left, const cow_iterator& right) noexcept {
+      return static_cast<difference_type>(left._index) - static_cast<difference_type>(right._index);
+    }
+
+    friend bool operator==(const cow_iterator& left, const cow_iterator& right) noexcept {
+      return left._index == right._index;
+    }
+
+    friend auto operator<=>(const cow_iterator& left, const cow_iterator& right) noexcept {
+      return left._index <=> right._index;
+    }
+
+  private:
+    socow_vector* _vector = nullptr;
+    size_t _index = 0;
+    [[no_unique_address]] call_site _site{};
+  };
+
+  struct cow_view {
+    socow_vector* vector;
+    [[no_unique_address]] call_site site;
+
+    cow_iterator begin() const noexcept {
+      return cow_iterator(vector, 0, site);
+    }
+
+    cow_iterator end() const noexcept {
+      return cow_iterator(vector, vector->size(), site);
+    }
+  };
+
+  cow_iterator cow_begin(SOCOW_TRACE_SITE_PARAMETER) noexcept {
+    return cow_iterator(this, 0, SOCOW_TRACE_SITE);
+  }
+
+  cow_iterator cow_end(SOCOW_TRACE_SITE_PARAMETER) noexcept {
+    return cow_iterator(this, size(), SOCOW_TRACE_SITE);
+  }
+
+  cow_view cow_elements(SOCOW_TRACE_SITE_PARAMETER) noexcept {
+    return cow_view{this, SOCOW_TRACE_SITE};
+  }
+
+  size_t use_count() const noexcept {
+    return is_small() ? 1 : _dynamic_data->references();
+  }
+
+  bool is_shared() const noexcept {
+    return use_count() > 1;
+  }
+
+  socow_memory_usage memory_usage() const {
+    socow_memory_usage result = socow_detail::element_heap_usage(data(), size());
+    result.inline_bytes = sizeof(socow_vector);
+    if (!is_small()) {
+      size_t references = use_count();
+      size_t own = sizeof(dynamic_storage) + sizeof(T) * capacity();
+      result.heap_bytes += own;
+      result.exclusive_bytes = references == 1 ? result.exclusive_bytes + own : 0;
+      result.proportional_bytes = (result.proportional_bytes + own) / references;
+    }
+    return result;
+  }
+
+  socow_storage_token storage_token() const noexcept {
+    if (is_small()) {
+      return {nullptr, 0, size()};
+    }
+    return {_dynamic_data, _dynamic_data->version(), size()};
+  }
+
+  size_t hash() const {
+    auto compute = [this] { return socow_detail::hash_range(data(), size()); };
+#if SOCOW_VECTOR_METADATA_CACHE
+    if (!is_small()) {
+      return _dynamic_data->_metadata.hash(compute);
+    }
+#endif
+    return compute();
+  }
+
+  bool is_sorted() const {
+    auto compute = [this] { return std::is_sorted(begin(), end()); };
+#if SOCOW_VECTOR_METADATA_CACHE
+    if (!is_small()) {
+      return _dynamic_data->_metadata.is_sorted(compute);
+    }
+#endif
+    return compute();
+  }
+
+  const_iterator min_element() const {
+    return begin() + min_max_indices().first;
+  }
+
+  const_iterator max_element() const {
+    return begin() + min_max_indices().second;
+  }
+
+private:
+  std::pair<size_t, size_t> min_max_indices() const {
+    auto compute = [this] {
+      auto [min, max] = std::minmax_element(begin(), end());
+      return std::pair<size_t, size_t>(min - begin(), max - begin());
+    };
+#if SOCOW_VECTOR_METADATA_CACHE
+    if (!is_small()) {
+      return _dynamic_data->_metadata.min_max(compute);
+    }
+#endif
+    return compute();
+  }
+
+public:
+  const_iterator find(const T& value) const {
+    return data() + socow_detail::find_index(data(), size(), value);
+  }
+
+  size_t count(const T& value) const {
+    return socow_detail::count(data(), size(), value);
+  }
+
+  bool contains(const T& value) const {
+    return find(value) != end();
+  }
+
+  iterator insert(const_iterator pos, const T& value SOCOW_TRACE_SITE_TRAILING_PARAMETER) {
     ptrdiff_t diff = pos - std::as_const(*this).data();
+    if (copied()) {
+      adopt_prepared_copy(SOCOW_TRACE_SITE);
+    }
     if (size() == capacity() || copied()) {
-      socow_vector new_vector;
-      new_vector.reserve(copied() ? capacity() + 1 : 2 * capacity());
-      for (size_t i = 0; i < diff; ++i) {
-        new_vector.push_back(std::as_const(*this)[i]);
+      note_reallocation(SOCOW_TRACE_SITE);
+      auto* new_dynamic_data = get_new_empty_storage(copied() ? capacity() + 1 : 2 * capacity());
+      try {
+        new (new_dynamic_data->_data + diff) T(value);
+      } catch (...) {
+        deallocate_storage(new_dynamic_data);
+        throw;
       }
-      new_vector.push_back(value);
-      for (size_t i = diff; i < size(); ++i) {
-        new_vector.push_back(std::as_const(*this)[i]);
+      try {
+        relocate_to(new_dynamic_data->_data, diff);
+      } catch (...) {
+        new_dynamic_data->_data[diff].~T();
+        deallocate_storage(new_dynamic_data);
+        throw;
       }
-      *this = new_vector;
+      dec_references();
+      _is_small = false;
+      _dynamic_data = new_dynamic_data;
+      ++_size;
+    } else if (static_cast<size_t>(diff) == size()) {
+      append(SOCOW_TRACE_SITE, value);
     } else {
-      push_back(value);
-      for (size_t i = size() - 1; i > diff; --i) {
-        std::swap((*this)[i], (*this)[i - 1]);
-      }
+      pointer elements = mutable_data(SOCOW_TRACE_SITE);
+      T copy(value);
+      new (elements + size()) T(std::move(elements[size() - 1]));
+      ++_size;
+      std::move_backward(elements + diff, elements + size() - 2, elements + size() - 1);
+      elements[diff] = std::move(copy);
     }
-    return data() + diff;
+    return mutable_data(SOCOW_TRACE_SITE) + diff;
   }
 
-  iterator erase(const_iterator pos) {
-    return erase(pos, pos + 1);
+  iterator erase(const_iterator pos SOCOW_TRACE_SITE_TRAILING_PARAMETER) {
+    return erase_range(pos, pos + 1, SOCOW_TRACE_SITE);
   }
 
-  iterator erase(const_iterator first, const_iterator last) {
+  iterator erase(const_iterator first, const_iterator last SOCOW_TRACE_SITE_TRAILING_PARAMETER) {
+    return erase_range(first, last, SOCOW_TRACE_SITE);
+  }
+
+private:
+  iterator erase_range(const_iterator first, const_iterator last, call_site site) {
     ptrdiff_t range = last - first;
     ptrdiff_t start = first - std::as_const(*this).data();
     if (first == last) {
-      return data() + start;
+      return mutable_data(site) + start;
     }
     if (copied()) {
-      socow_vector new_vector;
-      new_vector.reserve(capacity() - range);
-      for (size_t i = 0; i < start; ++i) {
+      adopt_prepared_copy(site);
+    }
+    if (copied()) {
+      note_detach(size() - range, site);
+      socow_vector new_vector(with_capacity_t(), capacity() - range);
+      for (size_t i = 0; i < static_cast<size_t>(start); ++i) {
         new_vector.push_back(std::as_const(*this)[i]);
       }
       for (size_t i = start + range; i < size(); ++i) {
         new_vector.push_back(std::as_const(*this)[i]);
       }
       swap(new_vector);
-      return data() + start;
+      return mutable_data(site) + start;
     }
 
-    for (size_t i = start; i < size() - range; i++) {
-      std::swap((*this)[i], (*this)[i + range]);
+    pointer elements = mutable_data(site);
+    std::move(elements + start + range, elements + size(), elements + start);
+    std::destroy_n(elements + size() - range, range);
+    _size -= range;
+    return elements + start;
+  }
+
+  bool shares_storage_with(const socow_vector& other) const noexcept {
+    return !is_small() && !other.is_small() && _dynamic_data == other._dynamic_data;
+  }
+
+public:
+  friend bool operator==(const socow_vector& left, const socow_vector& right) {
+    if (left.size() != right.size()) {
+      return false;
+    }
+    if (left.shares_storage_with(right)) {
+      return true;
     }
-    for (size_t i = 0; i < range; ++i) {
-      pop_back();
+    if constexpr (socow_detail::bitwise_comparable<T>) {
+      return left.empty() || std::memcmp(left.data(), right.data(), left.size() * sizeof(T)) == 0;
+    } else {
+      return std::equal(left.begin(), left.end(), right.begin());
+    }
+  }
+
+  friend auto operator<=>(const socow_vector& left, const socow_vector& right)
+    requires std::three_way_comparable<T>
+  {
+    using result_type = std::compare_three_way_result_t<T>;
+    if (left.size() == right.size() && left.shares_storage_with(right)) {
+      return result_type(std::strong_ordering::equal);
+    }
+    if constexpr (sizeof(T) == 1 && std::is_unsigned_v<T> && std::has_unique_object_representations_v<T>) {
+      size_t common_len = std::min(left.size(), right.size());
+      int result = common_len == 0 ? 0 : std::memcmp(left.data(), right.data(), common_len);
+      if (result != 0) {
+        return result_type(result <=> 0);
+      }
+      return result_type(left.size() <=> right.size());
+    } else {
+      return std::lexicographical_compare_three_way(left.begin(), left.end(), right.begin(), right.end());
     }
-    return data() + start;
+  }
+};
+
+namespace socow_detail {
+
+struct storage_access {
+  template <typename Vector>
+  using storage_type = typename Vector::dynamic_storage;
+
+  template <typename Vector>
+  static storage_type<Vector>* storage(const Vector& vector) noexcept {
+    return vector.is_small() ? nullptr : vector._dynamic_data;
+  }
+
+  template <typename Vector>
+  static void commit_size(Vector& vector, size_t size) noexcept {
+    assert(size <= vector.capacity());
+    if (!vector.is_small()) {
+      vector._dynamic_data->on_mutation();
+    }
+    vector._size = size;
+  }
+
+  template <typename Vector>
+  static Vector adopt(storage_type<Vector>* storage, size_t size) noexcept {
+    Vector result;
+    result._is_small = false;
+    result._dynamic_data = storage;
+    result._size = size;
+    return result;
+  }
+
+  template <typename Vector>
+  static bool shared(const Vector& vector) noexcept {
+    return vector.copied();
+  }
+
+  template <typename Vector>
+  static storage_type<Vector>* allocate(size_t capacity) {
+    return Vector::get_new_empty_storage(capacity);
+  }
+
+  template <typename Vector>
+  static void deallocate(storage_type<Vector>* storage) noexcept {
+    Vector::deallocate_storage(storage);
+  }
+
+  template <typename Vector>
+  static void note_detach(Vector& vector, typename Vector::call_site site) {
+    vector.note_detach(vector.size(), site);
+  }
+
+  template <typename Vector>
+  static void install(Vector& vector, storage_type<Vector>* storage, size_t size) noexcept {
+    vector.dec_references();
+    vector._is_small = false;
+    vector._dynamic_data = storage;
+    vector._size = size;
+  }
+
+  template <typename Vector>
+  static Vector adopt_external(typename Vector::pointer elements, size_t size, size_t capacity,
+                               external_buffer* owner, bool read_only) {
+    return Vector::from_external(elements, size, capacity, owner, read_only);
+  }
+};
+
+} // namespace socow_detail
+
+template <typename T, size_t SMALL_SIZE, size_t ALIGNMENT>
+struct socow_memory_traits<socow_vector<T, SMALL_SIZE, ALIGNMENT>> {
+  static constexpr bool HAS_HEAP = true;
+
+  static socow_memory_usage usage(const socow_vector<T, SMALL_SIZE, ALIGNMENT>& vector) {
+    return vector.memory_usage();
+  }
+};
+
+template <typename T, size_t SMALL_SIZE, size_t ALIGNMENT>
+struct std::hash<socow_vector<T, SMALL_SIZE, ALIGNMENT>> {
+  size_t operator()(const socow_vector<T, SMALL_SIZE, ALIGNMENT>& vector) const {
+    return vector.hash();
   }
 };
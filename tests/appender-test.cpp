@@ -0,0 +1,121 @@
+#include "socow-appender.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include <set>
+#include <thread>
+#include <vector>
+
+namespace socow_test {
+
+std::atomic<size_t> failing_allocation_size = SIZE_MAX;
+
+} // namespace socow_test
+
+void* operator new(size_t size) {
+  if (size >= socow_test::failing_allocation_size.load(std::memory_order_relaxed)) {
+    throw std::bad_alloc();
+  }
+  if (void* result = std::malloc(size == 0 ? 1 : size)) {
+    return result;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void* pointer) noexcept {
+  std::free(pointer);
+}
+
+void operator delete(void* pointer, size_t) noexcept {
+  std::free(pointer);
+}
+
+namespace socow_test {
+namespace {
+
+using int_vector = socow_vector<int, 4>;
+
+struct allocation_failure_scope {
+  explicit allocation_failure_scope(size_t size) {
+    failing_allocation_size = size;
+  }
+
+  ~allocation_failure_scope() {
+    failing_allocation_size = SIZE_MAX;
+  }
+};
+
+TEST(appender, appends_from_many_threads) {
+  int_vector v;
+  {
+    socow_concurrent_appender<int, 4> appender(v, 16);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+      threads.emplace_back([&appender, t] {
+        for (int i = 0; i < 1000; ++i) {
+          appender.push_back(t * 1000 + i);
+        }
+      });
+    }
+    for (std::thread& thread : threads) {
+      thread.join();
+    }
+  }
+  ASSERT_EQ(v.size(), 4000u);
+  std::set<int> values(std::as_const(v).begin(), std::as_const(v).end());
+  EXPECT_EQ(values.size(), 4000u);
+}
+
+TEST(appender, failed_growth_throws_and_keeps_committed_elements) {
+  int_vector v;
+  socow_concurrent_appender<int, 4> appender(v, 64);
+  size_t capacity = v.capacity();
+  allocation_failure_scope failure(capacity * sizeof(int));
+  for (size_t i = 0; i < capacity; ++i) {
+    appender.push_back(static_cast<int>(i));
+  }
+  EXPECT_THROW(appender.push_back(-1), std::bad_alloc);
+  EXPECT_THROW(appender.push_back(-2), std::bad_alloc);
+  appender.publish();
+  ASSERT_EQ(v.size(), capacity);
+  for (size_t i = 0; i < capacity; ++i) {
+    EXPECT_EQ(std::as_const(v)[i], static_cast<int>(i));
+  }
+}
+
+TEST(appender, failed_growth_releases_waiting_threads) {
+  int_vector v;
+  size_t capacity;
+  std::atomic<size_t> failures = 0;
+  {
+    socow_concurrent_appender<int, 4> appender(v, 256);
+    capacity = v.capacity();
+    allocation_failure_scope failure(capacity * sizeof(int));
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+      threads.emplace_back([&appender, &failures, t] {
+        try {
+          for (int i = 0; i < 1000; ++i) {
+            appender.push_back(t * 1000 + i);
+          }
+        } catch (const std::bad_alloc&) {
+          ++failures;
+        }
+      });
+    }
+    for (std::thread& thread : threads) {
+      thread.join();
+    }
+  }
+  EXPECT_EQ(failures.load(), 4u);
+  ASSERT_EQ(v.size(), capacity);
+  std::set<int> values(std::as_const(v).begin(), std::as_const(v).end());
+  EXPECT_EQ(values.size(), capacity);
+}
+
+} // namespace
+} // namespace socow_test
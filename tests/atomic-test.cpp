@@ -0,0 +1,65 @@
+#include "socow-atomic.h"
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+namespace socow_test {
+namespace {
+
+template <typename Vector>
+Vector iota(size_t size) {
+  Vector result;
+  for (size_t i = 0; i < size; ++i) {
+    result.push_back(static_cast<int>(i));
+  }
+  return result;
+}
+
+TEST(atomic_socow_vector, load_shares_published_storage) {
+  using vector = socow_vector<int, 4>;
+  vector initial = iota<vector>(100);
+  atomic_socow_vector<int, 4> published(initial);
+  vector snapshot = published.load();
+  EXPECT_EQ(std::as_const(snapshot).data(), std::as_const(initial).data());
+}
+
+TEST(atomic_socow_vector, over_aligned_snapshots) {
+  using aligned_vector = socow_vector<int, 4, 64>;
+  atomic_socow_vector<int, 4, 64> published(iota<aligned_vector>(100));
+  published.update([](aligned_vector& value) { value.push_back(100); });
+  aligned_vector snapshot = published.load();
+  ASSERT_EQ(snapshot.size(), 101u);
+  EXPECT_EQ(snapshot[100], 100);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(std::as_const(snapshot).data()) % 64, 0u);
+}
+
+TEST(atomic_socow_vector, concurrent_updates_and_loads) {
+  using vector = socow_vector<int, 4>;
+  atomic_socow_vector<int, 4> published(iota<vector>(64));
+  std::vector<std::thread> threads;
+  threads.emplace_back([&] {
+    for (int i = 0; i < 500; ++i) {
+      published.update([i](vector& value) { value[0] = i; });
+    }
+  });
+  for (size_t t = 0; t < 3; ++t) {
+    threads.emplace_back([&] {
+      for (size_t i = 0; i < 500; ++i) {
+        vector snapshot = published.load();
+        ASSERT_EQ(snapshot.size(), 64u);
+        EXPECT_EQ(snapshot[63], 63);
+      }
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(published.load()[0], 499);
+}
+
+} // namespace
+} // namespace socow_test
@@ -0,0 +1,71 @@
+#include "socow-vector.h"
+
+#include <gtest/gtest.h>
+
+#include <cctype>
+#include <cstddef>
+#include <functional>
+#include <string_view>
+
+namespace socow_test {
+
+struct ci_char {
+  char value;
+
+  friend bool operator==(ci_char left, ci_char right) noexcept {
+    return std::tolower(static_cast<unsigned char>(left.value)) ==
+           std::tolower(static_cast<unsigned char>(right.value));
+  }
+};
+
+} // namespace socow_test
+
+template <>
+struct std::hash<socow_test::ci_char> {
+  size_t operator()(socow_test::ci_char c) const noexcept {
+    return std::hash<int>()(std::tolower(static_cast<unsigned char>(c.value)));
+  }
+};
+
+namespace socow_test {
+namespace {
+
+using ci_vector = socow_vector<ci_char, 4>;
+
+ci_vector make(std::string_view text) {
+  ci_vector result;
+  for (char c : text) {
+    result.push_back(ci_char{c});
+  }
+  return result;
+}
+
+TEST(compare, uses_element_equality_for_class_types) {
+  static_assert(std::has_unique_object_representations_v<ci_char>);
+  EXPECT_TRUE(make("Hello, World") == make("hello, world"));
+  EXPECT_FALSE(make("Hello, World") == make("hello, there"));
+  EXPECT_TRUE(make("Abc") == make("aBC"));
+}
+
+TEST(compare, hash_is_consistent_with_equality) {
+  std::hash<ci_vector> hash;
+  EXPECT_EQ(hash(make("Hello, World")), hash(make("hello, world")));
+  EXPECT_EQ(hash(make("Abc")), hash(make("aBC")));
+}
+
+TEST(compare, bitwise_path_for_scalars) {
+  using int_vector = socow_vector<int, 2>;
+  int_vector left;
+  int_vector right;
+  for (int i = 0; i < 16; ++i) {
+    left.push_back(i);
+    right.push_back(i);
+  }
+  EXPECT_TRUE(left == right);
+  EXPECT_EQ(std::hash<int_vector>()(left), std::hash<int_vector>()(right));
+  right.push_back(16);
+  EXPECT_FALSE(left == right);
+}
+
+} // namespace
+} // namespace socow_test
@@ -0,0 +1,206 @@
+#include "counted.h"
+#include "socow-vector.h"
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <utility>
+
+namespace socow_test {
+namespace {
+
+constexpr size_t SMALL_SIZE = 4;
+using vector = socow_vector<counted, SMALL_SIZE>;
+
+vector make_vector(size_t size, size_t capacity = 0) {
+  vector result;
+  result.reserve(std::max(size, capacity));
+  for (size_t i = 0; i < size; ++i) {
+    result.push_back(counted(i));
+  }
+  return result;
+}
+
+struct operation_record {
+  operation_counts counts;
+  size_t allocations;
+};
+
+template <typename F>
+operation_record record(F operation) {
+  counts = {};
+  socow_stats::reset_thread_stats();
+  operation();
+  return {counts, socow_stats::thread_stats().allocations};
+}
+
+void expect_counts(const operation_record& actual, size_t copies, size_t moves, size_t destructions,
+                   size_t allocations) {
+  EXPECT_EQ(actual.counts.copies, copies);
+  EXPECT_EQ(actual.counts.moves, moves);
+  EXPECT_EQ(actual.counts.destructions, destructions);
+  EXPECT_EQ(actual.allocations, allocations);
+}
+
+TEST(complexity, copy_of_big_vector_shares_the_buffer) {
+  vector source = make_vector(16);
+  expect_counts(record([&] { vector copy(source); }), 0, 0, 0, 0);
+}
+
+TEST(complexity, copy_of_small_vector_copies_elements) {
+  vector source = make_vector(3);
+  expect_counts(record([&] { vector copy(source); }), 3, 0, 3, 0);
+}
+
+TEST(complexity, const_access_to_shared_buffer_does_not_detach) {
+  vector source = make_vector(16);
+  vector copy(source);
+  expect_counts(record([&] {
+    EXPECT_EQ(std::as_const(copy)[0].value, 0u);
+    EXPECT_EQ(std::as_const(copy).begin()->value, 0u);
+  }), 0, 0, 0, 0);
+}
+
+TEST(complexity, first_write_to_shared_buffer_copies_once) {
+  vector source = make_vector(16);
+  vector copy(source);
+  expect_counts(record([&] { copy[0] = counted(7); }), 16, 1, 1, 1);
+  EXPECT_EQ(source[0].value, 0u);
+}
+
+TEST(complexity, write_to_unique_buffer_does_not_copy) {
+  vector v = make_vector(16);
+  expect_counts(record([&] { v[0] = counted(7); }), 0, 1, 1, 0);
+}
+
+TEST(complexity, push_back_into_full_unique_buffer_moves) {
+  vector v = make_vector(8);
+  ASSERT_EQ(v.capacity(), 8u);
+  expect_counts(record([&] { v.push_back(counted(8)); }), 0, 9, 9, 1);
+}
+
+TEST(complexity, push_back_into_reserved_buffer_does_not_relocate) {
+  vector v;
+  expect_counts(record([&] {
+    v.reserve(64);
+    for (size_t i = 0; i < 64; ++i) {
+      v.push_back(counted(i));
+    }
+  }), 0, 64, 64, 1);
+}
+
+TEST(complexity, insert_into_full_unique_buffer_moves) {
+  vector v = make_vector(8);
+  ASSERT_EQ(v.capacity(), 8u);
+  counted value(7);
+  expect_counts(record([&] { v.insert(std::as_const(v).begin() + 4, value); }), 1, 8, 8, 1);
+  EXPECT_EQ(v[4].value, 7u);
+  EXPECT_EQ(v[8].value, 7u);
+}
+
+TEST(complexity, insert_into_shared_buffer_copies) {
+  vector source = make_vector(8);
+  vector v(source);
+  counted value(7);
+  expect_counts(record([&] { v.insert(std::as_const(v).begin() + 4, value); }), 9, 0, 0, 1);
+  EXPECT_EQ(source.size(), 8u);
+}
+
+TEST(complexity, insert_with_spare_capacity_shifts_in_place) {
+  vector v = make_vector(8, 9);
+  counted value(7);
+  expect_counts(record([&] { v.insert(std::as_const(v).begin() + 4, value); }), 1, 5, 1, 0);
+}
+
+TEST(complexity, erase_from_unique_buffer_shifts_in_place) {
+  vector v = make_vector(16);
+  expect_counts(record([&] { v.erase(std::as_const(v).begin() + 8); }), 0, 7, 1, 0);
+}
+
+TEST(complexity, swap_of_big_vectors_exchanges_pointers) {
+  vector left = make_vector(16);
+  vector right = make_vector(32);
+  expect_counts(record([&] { left.swap(right); }), 0, 0, 0, 0);
+}
+
+TEST(complexity, clear_of_unique_buffer_destroys_elements) {
+  vector v = make_vector(16);
+  expect_counts(record([&] { v.clear(); }), 0, 0, 16, 0);
+}
+
+TEST(complexity, clear_of_shared_buffer_only_releases_reference) {
+  vector source = make_vector(16);
+  vector v(source);
+  expect_counts(record([&] { v.clear(); }), 0, 0, 0, 0);
+}
+
+TEST(complexity, pop_back_from_unique_buffer_destroys_one) {
+  vector v = make_vector(16);
+  expect_counts(record([&] { v.pop_back(); }), 0, 0, 1, 0);
+}
+
+TEST(complexity, pop_back_from_shared_buffer_copies_the_rest) {
+  vector source = make_vector(16);
+  vector v(source);
+  expect_counts(record([&] { v.pop_back(); }), 15, 0, 0, 1);
+  EXPECT_EQ(source.size(), 16u);
+}
+
+TEST(complexity, reserve_on_shared_buffer_copies) {
+  vector source = make_vector(16);
+  vector v(source);
+  expect_counts(record([&] { v.reserve(32); }), 16, 0, 0, 1);
+  EXPECT_EQ(v.capacity(), 32u);
+}
+
+TEST(complexity, reserve_on_unique_buffer_moves) {
+  vector v = make_vector(16);
+  expect_counts(record([&] { v.reserve(32); }), 0, 16, 16, 1);
+}
+
+TEST(complexity, shrink_to_fit_of_unique_buffer_moves) {
+  vector v = make_vector(10, 16);
+  expect_counts(record([&] { v.shrink_to_fit(); }), 0, 10, 10, 1);
+  EXPECT_EQ(v.capacity(), 10u);
+}
+
+TEST(complexity, shrink_to_fit_into_small_buffer_copies) {
+  vector v = make_vector(3, 16);
+  expect_counts(record([&] { v.shrink_to_fit(); }), 3, 0, 3, 0);
+  EXPECT_EQ(v.capacity(), SMALL_SIZE);
+}
+
+TEST(complexity, copy_assignment_of_big_vector_shares_the_buffer) {
+  vector source = make_vector(16);
+  vector v = make_vector(8);
+  expect_counts(record([&] { v = source; }), 0, 0, 8, 0);
+}
+
+TEST(complexity, move_assignment_of_big_vector_steals_the_buffer) {
+  vector source = make_vector(16);
+  vector v = make_vector(8);
+  expect_counts(record([&] { v = std::move(source); }), 0, 0, 8, 0);
+}
+
+TEST(complexity, range_erase_from_unique_buffer_shifts_in_place) {
+  vector v = make_vector(16);
+  expect_counts(record([&] { v.erase(std::as_const(v).begin() + 4, std::as_const(v).begin() + 8); }), 0, 8, 4, 0);
+}
+
+TEST(complexity, erase_from_shared_buffer_copies_the_rest) {
+  vector source = make_vector(16);
+  vector v(source);
+  expect_counts(record([&] { v.erase(std::as_const(v).begin() + 8); }), 15, 0, 0, 1);
+  EXPECT_EQ(source.size(), 16u);
+}
+
+TEST(complexity, swap_of_small_and_big_vectors_copies_small_elements) {
+  vector small = make_vector(3);
+  vector big = make_vector(16);
+  expect_counts(record([&] { small.swap(big); }), 3, 0, 3, 0);
+  EXPECT_EQ(small.size(), 16u);
+  EXPECT_EQ(big.size(), 3u);
+}
+
+} // namespace
+} // namespace socow_test
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstddef>
+
+namespace socow_test {
+
+struct operation_counts {
+  size_t copies = 0;
+  size_t moves = 0;
+  size_t destructions = 0;
+
+  bool operator==(const operation_counts&) const = default;
+};
+
+inline operation_counts counts;
+
+struct counted {
+  size_t value;
+
+  counted(size_t value = 0) noexcept : value(value) {}
+
+  counted(const counted& other) noexcept : value(other.value) {
+    ++counts.copies;
+  }
+
+  counted(counted&& other) noexcept : value(other.value) {
+    ++counts.moves;
+  }
+
+  counted& operator=(const counted& other) noexcept {
+    ++counts.copies;
+    value = other.value;
+    return *this;
+  }
+
+  counted& operator=(counted&& other) noexcept {
+    ++counts.moves;
+    value = other.value;
+    return *this;
+  }
+
+  ~counted() {
+    ++counts.destructions;
+  }
+
+  bool operator==(const counted& other) const noexcept {
+    return value == other.value;
+  }
+};
+
+} // namespace socow_test
@@ -0,0 +1,57 @@
+#include "socow-vector.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace socow_test {
+namespace {
+
+using string_vector = socow_vector<std::string, 2>;
+
+std::vector<std::string> long_strings(size_t count) {
+  std::vector<std::string> result;
+  for (size_t i = 0; i < count; ++i) {
+    result.push_back(std::string(64, char('a' + i)));
+  }
+  return result;
+}
+
+TEST(cow_reference, assignment_from_sibling_of_read_only_storage) {
+  string_vector v = string_vector::from_std_vector(long_strings(4));
+  *v.cow_begin() = *(v.cow_begin() + 1);
+  EXPECT_EQ(std::as_const(v)[0], std::string(64, 'b'));
+  EXPECT_EQ(std::as_const(v)[1], std::string(64, 'b'));
+}
+
+TEST(cow_reference, assignment_from_own_element_of_read_only_storage) {
+  string_vector v = string_vector::from_std_vector(long_strings(4));
+  const std::string& source = std::as_const(v)[3];
+  v.cow_begin()[0] = source;
+  EXPECT_EQ(std::as_const(v)[0], std::string(64, 'd'));
+  EXPECT_EQ(std::as_const(v)[3], std::string(64, 'd'));
+}
+
+TEST(cow_reference, assignment_from_sibling_of_shared_storage) {
+  string_vector v = string_vector::from_std_vector(long_strings(4));
+  string_vector copy(v);
+  v.cow_begin()[2] = v.cow_begin()[3];
+  EXPECT_EQ(std::as_const(v)[2], std::string(64, 'd'));
+  EXPECT_EQ(std::as_const(copy)[2], std::string(64, 'c'));
+}
+
+TEST(cow_reference, assignment_to_unique_storage_does_not_detach) {
+  string_vector v;
+  for (std::string& value : long_strings(4)) {
+    v.push_back(std::move(value));
+  }
+  const std::string* before = std::as_const(v).data();
+  *v.cow_begin() = *(v.cow_begin() + 1);
+  EXPECT_EQ(std::as_const(v).data(), before);
+  EXPECT_EQ(std::as_const(v)[0], std::string(64, 'b'));
+}
+
+} // namespace
+} // namespace socow_test
@@ -0,0 +1,71 @@
+#include "socow-vector.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstddef>
+#include <thread>
+
+static_assert(SOCOW_VECTOR_EPOCH_RECLAMATION, "this test checks epoch reclamation");
+
+namespace socow_test {
+namespace {
+
+using domain = socow_detail::epoch_domain;
+
+std::atomic<size_t> destroyed = 0;
+
+void count_destruction(void*, size_t) noexcept {
+  ++destroyed;
+}
+
+TEST(epoch, byte_threshold_reclaims_before_count_threshold) {
+  static_assert(domain::RECLAIM_COUNT > 4);
+  socow_epoch_reclaim();
+  destroyed = 0;
+  for (size_t i = 0; i < 4; ++i) {
+    domain::instance().retire(nullptr, 0, domain::RECLAIM_BYTES / 2, &count_destruction);
+  }
+  EXPECT_GE(destroyed.load(), 2u);
+}
+
+TEST(epoch, small_retirements_wait_for_count_threshold) {
+  socow_epoch_reclaim();
+  socow_epoch_reclaim();
+  socow_epoch_reclaim();
+  destroyed = 0;
+  domain::instance().retire(nullptr, 0, 16, &count_destruction);
+  domain::instance().retire(nullptr, 0, 16, &count_destruction);
+  EXPECT_EQ(destroyed.load(), 0u);
+  socow_epoch_reclaim();
+  socow_epoch_reclaim();
+  EXPECT_EQ(destroyed.load(), 2u);
+}
+
+TEST(epoch, thread_exit_flushes_its_retirements) {
+  destroyed = 0;
+  std::thread worker([] {
+    for (size_t i = 0; i < 3; ++i) {
+      domain::instance().retire(nullptr, 0, 16, &count_destruction);
+    }
+  });
+  worker.join();
+  EXPECT_EQ(destroyed.load(), 3u);
+}
+
+TEST(epoch, thread_exit_keeps_retirements_protected_by_readers) {
+  destroyed = 0;
+  {
+    socow_epoch_guard guard;
+    std::thread worker([] { domain::instance().retire(nullptr, 0, 16, &count_destruction); });
+    worker.join();
+    EXPECT_EQ(destroyed.load(), 0u);
+  }
+  socow_epoch_reclaim();
+  socow_epoch_reclaim();
+  socow_epoch_reclaim();
+  EXPECT_EQ(destroyed.load(), 1u);
+}
+
+} // namespace
+} // namespace socow_test
@@ -0,0 +1,113 @@
+#include "socow-intern.h"
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace socow_test {
+namespace {
+
+using string_vector = socow_vector<std::string, 2>;
+
+string_vector letters(size_t capacity = 8) {
+  string_vector result;
+  result.reserve(capacity);
+  for (size_t i = 0; i < 8; ++i) {
+    result.push_back(std::string(40, char('a' + i)));
+  }
+  return result;
+}
+
+void expect_letters(const string_vector& vector) {
+  ASSERT_GE(vector.size(), 8u);
+  for (size_t i = 0; i < 8; ++i) {
+    EXPECT_EQ(vector[i], std::string(40, char('a' + i)));
+  }
+}
+
+TEST(intern, relocated_storage_leaves_table) {
+  socow_intern_table<std::string, 2> table;
+  string_vector first = letters();
+  EXPECT_FALSE(socow_intern(first, table));
+  EXPECT_EQ(table.size(), 1u);
+  first.push_back("tail");
+  EXPECT_EQ(table.size(), 0u);
+
+  string_vector second = letters();
+  EXPECT_FALSE(socow_intern(second, table));
+  expect_letters(second);
+}
+
+TEST(intern, copy_on_write_leaves_table) {
+  socow_intern_table<std::string, 2> table;
+  string_vector first = letters(16);
+  socow_intern(first, table);
+  first.reserve(32);
+  EXPECT_EQ(table.size(), 0u);
+  expect_letters(first);
+}
+
+TEST(intern, sibling_detach_keeps_shared_storage) {
+  socow_intern_table<std::string, 2> table;
+  string_vector first = letters();
+  socow_intern(first, table);
+  string_vector second = first;
+  second[0] = "changed";
+  EXPECT_EQ(table.size(), 1u);
+  expect_letters(first);
+
+  string_vector third = letters();
+  EXPECT_TRUE(socow_intern(third, table));
+  EXPECT_EQ(std::as_const(first).data(), std::as_const(third).data());
+}
+
+TEST(intern, over_aligned_vectors_share_storage) {
+  using aligned_vector = socow_vector<int, 2, 64>;
+  socow_intern_table<int, 2, 64> table;
+  aligned_vector first;
+  aligned_vector second;
+  for (int i = 0; i < 32; ++i) {
+    first.push_back(i);
+    second.push_back(i);
+  }
+  EXPECT_FALSE(socow_intern(first, table));
+  EXPECT_TRUE(socow_intern(second, table));
+  EXPECT_EQ(std::as_const(first).data(), std::as_const(second).data());
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(std::as_const(second).data()) % 64, 0u);
+}
+
+TEST(intern, concurrent_intern_and_relocation) {
+  auto work = [] {
+    for (size_t i = 0; i < 500; ++i) {
+      string_vector grown = letters();
+      socow_intern(grown);
+      grown.push_back("tail");
+      expect_letters(grown);
+
+      string_vector inserted = letters();
+      socow_intern(inserted);
+      inserted.insert(std::as_const(inserted).begin() + 8, std::string(40, 'z'));
+      expect_letters(inserted);
+
+      string_vector reserved = letters();
+      socow_intern(reserved);
+      reserved.reserve(64);
+      expect_letters(reserved);
+    }
+  };
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < 4; ++i) {
+    threads.emplace_back(work);
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+}
+
+} // namespace
+} // namespace socow_test
@@ -0,0 +1,187 @@
+#include "socow-io.h"
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstddef>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <unistd.h>
+
+namespace socow_test {
+namespace {
+
+using byte_vector = socow_vector<char, 16>;
+
+byte_vector pattern(size_t size, size_t seed) {
+  byte_vector result;
+  result.reserve(size);
+  for (size_t i = 0; i < size; ++i) {
+    result.push_back(static_cast<char>((i * 31 + seed) % 251));
+  }
+  return result;
+}
+
+byte_vector concatenated(const std::vector<byte_vector>& parts) {
+  byte_vector result;
+  for (const byte_vector& part : parts) {
+    for (char c : part) {
+      result.push_back(c);
+    }
+  }
+  return result;
+}
+
+byte_vector read_all(int fd, size_t chunk) {
+  byte_vector result;
+  while (socow_append_from_fd(result, fd, chunk) > 0) {
+  }
+  return result;
+}
+
+struct pipe_pair {
+  std::array<int, 2> fds;
+
+  pipe_pair() {
+    if (pipe(fds.data()) != 0) {
+      std::abort();
+    }
+  }
+
+  ~pipe_pair() {
+    close_write();
+    close(fds[0]);
+  }
+
+  void close_write() {
+    if (fds[1] >= 0) {
+      close(fds[1]);
+      fds[1] = -1;
+    }
+  }
+};
+
+void ignore_signal(int) {}
+
+void install_interrupting_handler() {
+  struct sigaction action = {};
+  action.sa_handler = ignore_signal;
+  sigemptyset(&action.sa_mask);
+  action.sa_flags = 0;
+  sigaction(SIGUSR1, &action, nullptr);
+}
+
+TEST(io, temp_file_round_trip) {
+  char path[] = "/tmp/socow-io-XXXXXX";
+  int fd = mkstemp(path);
+  ASSERT_GE(fd, 0);
+  unlink(path);
+
+  std::vector<byte_vector> parts = {pattern(3, 1), pattern(100000, 2), byte_vector(), pattern(7, 3)};
+  byte_vector shared = parts[1];
+  parts.push_back(shared);
+  byte_vector expected = concatenated(parts);
+
+  ssize_t written = socow_write_to_fd(fd, std::span<const byte_vector>(parts));
+  EXPECT_EQ(written, static_cast<ssize_t>(expected.size()));
+  ASSERT_EQ(lseek(fd, 0, SEEK_SET), 0);
+  EXPECT_EQ(read_all(fd, 4096), expected);
+  close(fd);
+}
+
+TEST(io, pipe_round_trip_with_short_reads) {
+  pipe_pair pipe;
+  byte_vector expected = pattern(1000, 4);
+  ASSERT_EQ(socow_write_to_fd(pipe.fds[1], expected), 1000);
+  pipe.close_write();
+  byte_vector result = read_all(pipe.fds[0], 7);
+  EXPECT_EQ(result, expected);
+}
+
+TEST(io, pipe_round_trip_with_short_writes) {
+  pipe_pair pipe;
+  std::vector<byte_vector> parts;
+  for (size_t i = 0; i < 64; ++i) {
+    parts.push_back(pattern(4096 + i, i));
+  }
+  byte_vector expected = concatenated(parts);
+
+  byte_vector result;
+  std::thread reader([&] { result = read_all(pipe.fds[0], 1000); });
+  ssize_t written = socow_write_to_fd(pipe.fds[1], std::span<const byte_vector>(parts));
+  pipe.close_write();
+  reader.join();
+  EXPECT_EQ(written, static_cast<ssize_t>(expected.size()));
+  EXPECT_EQ(result, expected);
+}
+
+TEST(io, nonblocking_write_reports_partial_progress) {
+  pipe_pair pipe;
+  ASSERT_EQ(fcntl(pipe.fds[1], F_SETFL, O_NONBLOCK), 0);
+  byte_vector big = pattern(1 << 20, 5);
+  ssize_t written = socow_write_to_fd(pipe.fds[1], big);
+  ASSERT_GT(written, 0);
+  ASSERT_LT(written, static_cast<ssize_t>(big.size()));
+  pipe.close_write();
+
+  byte_vector result = read_all(pipe.fds[0], 65536);
+  ASSERT_EQ(result.size(), static_cast<size_t>(written));
+  EXPECT_TRUE(std::equal(result.begin(), result.end(), big.begin()));
+}
+
+TEST(io, interrupted_calls_are_retried) {
+  install_interrupting_handler();
+  pipe_pair pipe;
+  std::vector<byte_vector> parts = {pattern(200000, 6), pattern(200000, 7)};
+  byte_vector expected = concatenated(parts);
+  pthread_t writer_thread = pthread_self();
+  std::atomic<bool> done = false;
+
+  std::thread interrupter([&] {
+    for (size_t i = 0; i < 5; ++i) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(5));
+      pthread_kill(writer_thread, SIGUSR1);
+    }
+    byte_vector result = read_all(pipe.fds[0], 4096);
+    EXPECT_EQ(result, expected);
+    done = true;
+  });
+  ssize_t written = socow_write_to_fd(pipe.fds[1], std::span<const byte_vector>(parts));
+  pipe.close_write();
+  interrupter.join();
+  EXPECT_TRUE(done);
+  EXPECT_EQ(written, static_cast<ssize_t>(expected.size()));
+}
+
+TEST(io, interrupted_read_is_retried) {
+  install_interrupting_handler();
+  pipe_pair pipe;
+  pthread_t reader_thread = pthread_self();
+  byte_vector expected = pattern(100, 8);
+
+  std::thread writer([&] {
+    for (size_t i = 0; i < 3; ++i) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(5));
+      pthread_kill(reader_thread, SIGUSR1);
+    }
+    socow_write_to_fd(pipe.fds[1], expected);
+    pipe.close_write();
+  });
+  byte_vector result;
+  ssize_t first = socow_append_from_fd(result, pipe.fds[0], 1000);
+  writer.join();
+  EXPECT_GT(first, 0);
+  while (socow_append_from_fd(result, pipe.fds[0], 1000) > 0) {
+  }
+  EXPECT_EQ(result, expected);
+}
+
+} // namespace
+} // namespace socow_test
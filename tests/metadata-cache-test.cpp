@@ -0,0 +1,90 @@
+#include "socow-vector.h"
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <utility>
+
+static_assert(SOCOW_VECTOR_METADATA_CACHE, "this test checks the metadata cache");
+
+namespace socow_test {
+namespace {
+
+using int_vector = socow_vector<int, 2>;
+
+int_vector iota(size_t size) {
+  int_vector result;
+  for (size_t i = 0; i < size; ++i) {
+    result.push_back(static_cast<int>(i));
+  }
+  return result;
+}
+
+int_vector rebuilt(const int_vector& vector) {
+  int_vector result;
+  for (int value : vector) {
+    result.push_back(value);
+  }
+  return result;
+}
+
+void expect_fresh(const int_vector& vector) {
+  int_vector reference = rebuilt(vector);
+  EXPECT_EQ(vector.hash(), reference.hash());
+  EXPECT_EQ(vector.is_sorted(), reference.is_sorted());
+  EXPECT_EQ(vector.min_element() - vector.begin(), reference.min_element() - reference.begin());
+  EXPECT_EQ(vector.max_element() - vector.begin(), reference.max_element() - reference.begin());
+}
+
+template <typename F>
+void check_invalidation(F mutate) {
+  int_vector v = iota(16);
+  expect_fresh(v);
+  mutate(v);
+  expect_fresh(v);
+}
+
+TEST(metadata_cache, shared_by_copies) {
+  int_vector v = iota(16);
+  int_vector copy(v);
+  EXPECT_EQ(v.hash(), copy.hash());
+  EXPECT_TRUE(copy.is_sorted());
+  expect_fresh(copy);
+}
+
+TEST(metadata_cache, invalidated_by_subscript) {
+  check_invalidation([](int_vector& v) { v[3] = -1; });
+}
+
+TEST(metadata_cache, invalidated_by_iterator) {
+  check_invalidation([](int_vector& v) { *(v.begin() + 5) = 100; });
+}
+
+TEST(metadata_cache, invalidated_by_front_and_back) {
+  check_invalidation([](int_vector& v) { v.front() = 50; });
+  check_invalidation([](int_vector& v) { v.back() = -50; });
+}
+
+TEST(metadata_cache, invalidated_by_cow_reference) {
+  check_invalidation([](int_vector& v) { v.cow_begin()[7] = -7; });
+}
+
+TEST(metadata_cache, invalidated_by_size_changes) {
+  check_invalidation([](int_vector& v) { v.push_back(-1); });
+  check_invalidation([](int_vector& v) { v.pop_back(); });
+  check_invalidation([](int_vector& v) { v.insert(std::as_const(v).begin() + 2, -2); });
+  check_invalidation([](int_vector& v) { v.erase(std::as_const(v).begin() + 2); });
+  check_invalidation([](int_vector& v) { v.clear(); });
+}
+
+TEST(metadata_cache, detached_copy_keeps_source_cache) {
+  int_vector v = iota(16);
+  int_vector copy(v);
+  EXPECT_TRUE(v.is_sorted());
+  copy[0] = 100;
+  EXPECT_TRUE(v.is_sorted());
+  EXPECT_FALSE(copy.is_sorted());
+}
+
+} // namespace
+} // namespace socow_test
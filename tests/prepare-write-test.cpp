@@ -0,0 +1,102 @@
+#include "socow-vector.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace socow_test {
+namespace {
+
+using string_vector = socow_vector<std::string, 2>;
+
+string_vector letters(size_t size) {
+  string_vector result;
+  for (size_t i = 0; i < size; ++i) {
+    result.push_back(std::string(32, char('a' + i % 26)));
+  }
+  return result;
+}
+
+TEST(prepare_write, unique_storage_is_not_prepared) {
+  string_vector v = letters(8);
+  EXPECT_FALSE(v.prepare_write());
+}
+
+TEST(prepare_write, prepared_copy_is_adopted_on_write) {
+  string_vector source = letters(64);
+  string_vector writer(source);
+  EXPECT_TRUE(writer.prepare_write());
+  writer[0] = "changed";
+  EXPECT_EQ(std::as_const(writer)[0], "changed");
+  EXPECT_EQ(std::as_const(writer)[1], std::string(32, 'b'));
+  EXPECT_EQ(std::as_const(source)[0], std::string(32, 'a'));
+  EXPECT_NE(std::as_const(writer).data(), std::as_const(source).data());
+}
+
+TEST(prepare_write, copy_is_dropped_when_storage_becomes_unique) {
+  std::optional<string_vector> source(letters(64));
+  string_vector writer(*source);
+  EXPECT_TRUE(writer.prepare_write());
+  socow_reclaim_drain();
+  source.reset();
+  const std::string* before = std::as_const(writer).data();
+  writer[0] = "in place";
+  EXPECT_EQ(std::as_const(writer).data(), before);
+
+  string_vector copy(writer);
+  copy[1] = "detached";
+  EXPECT_EQ(std::as_const(copy)[0], "in place");
+  EXPECT_EQ(std::as_const(copy)[1], "detached");
+  EXPECT_EQ(std::as_const(writer)[1], std::string(32, 'b'));
+}
+
+TEST(prepare_write, full_queue_falls_back_to_synchronous_detach) {
+  static std::atomic<bool> worker_blocked = false;
+  static std::atomic<bool> worker_released = false;
+  auto block = [](void*, size_t) noexcept {
+    worker_blocked = true;
+    while (!worker_released) {
+      std::this_thread::yield();
+    }
+  };
+  ASSERT_TRUE(socow_detail::background_worker::post(nullptr, 0, block));
+  while (!worker_blocked) {
+    std::this_thread::yield();
+  }
+
+  constexpr size_t QUEUE_CAPACITY = socow_detail::background_worker::QUEUE_CAPACITY;
+  std::vector<string_vector> sources;
+  for (size_t i = 0; i <= QUEUE_CAPACITY; ++i) {
+    sources.push_back(letters(64));
+  }
+  std::vector<string_vector> writers(sources.begin(), sources.end());
+  for (size_t i = 0; i < QUEUE_CAPACITY; ++i) {
+    EXPECT_TRUE(writers[i].prepare_write());
+  }
+  string_vector& rejected = writers[QUEUE_CAPACITY];
+  EXPECT_FALSE(rejected.prepare_write());
+  rejected[0] = "synchronous";
+  EXPECT_NE(std::as_const(rejected).data(), std::as_const(sources[QUEUE_CAPACITY]).data());
+  EXPECT_EQ(rejected.use_count(), 1u);
+  EXPECT_EQ(std::as_const(sources[QUEUE_CAPACITY])[0], std::string(32, 'a'));
+
+  worker_released = true;
+  socow_reclaim_drain();
+  for (size_t i = 0; i < writers.size(); ++i) {
+    writers[i][0] = std::to_string(i);
+  }
+  for (size_t i = 0; i < writers.size(); ++i) {
+    EXPECT_EQ(std::as_const(writers[i])[0], std::to_string(i));
+    EXPECT_EQ(std::as_const(writers[i])[63], std::string(32, 'l'));
+    EXPECT_EQ(std::as_const(sources[i])[0], std::string(32, 'a'));
+  }
+}
+
+} // namespace
+} // namespace socow_test
@@ -0,0 +1,113 @@
+#include "socow-shm.h"
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace socow_test {
+namespace {
+
+using int_vector = socow_vector<int, 2>;
+
+int_vector iota(size_t size) {
+  int_vector result;
+  for (size_t i = 0; i < size; ++i) {
+    result.push_back(static_cast<int>(i));
+  }
+  return result;
+}
+
+void expect_iota(const int_vector& vector, size_t size) {
+  ASSERT_EQ(vector.size(), size);
+  for (size_t i = 0; i < size; ++i) {
+    EXPECT_EQ(vector[i], static_cast<int>(i));
+  }
+}
+
+size_t segment_mappings() {
+  std::ifstream maps("/proc/self/maps");
+  size_t result = 0;
+  for (std::string line; std::getline(maps, line);) {
+    result += line.find("memfd:socow-vector") != std::string::npos;
+  }
+  return result;
+}
+
+TEST(shm_segment, copy_outlives_segment) {
+  std::optional<int_vector> copy;
+  {
+    socow_shm_segment segment = socow_shm_segment::create(1 << 16);
+    copy = segment.copy(iota(100));
+    EXPECT_TRUE(segment.contains(*copy));
+  }
+  expect_iota(*copy, 100);
+  int_vector sibling(*copy);
+  copy.reset();
+  expect_iota(sibling, 100);
+}
+
+TEST(shm_segment, adopted_vector_outlives_both_segments) {
+  std::optional<int_vector> adopted;
+  {
+    socow_shm_segment segment = socow_shm_segment::create(1 << 16);
+    socow_shm_handle handle = segment.share(iota(50));
+    socow_shm_segment attached = socow_shm_segment::open(segment.fd());
+    adopted = attached.adopt<int, 2>(handle);
+  }
+  expect_iota(*adopted, 50);
+  adopted->push_back(50);
+  expect_iota(*adopted, 51);
+}
+
+TEST(shm_segment, moved_segment_keeps_mapping) {
+  socow_shm_segment segment = socow_shm_segment::create(1 << 16);
+  int_vector copy = segment.copy(iota(10));
+  socow_shm_segment moved(std::move(segment));
+  segment = socow_shm_segment::create(1 << 16);
+  expect_iota(copy, 10);
+  EXPECT_TRUE(moved.contains(copy));
+  EXPECT_FALSE(segment.contains(copy));
+}
+
+TEST(shm_segment, vectors_released_before_segment) {
+  socow_shm_segment segment = socow_shm_segment::create(1 << 16);
+  {
+    int_vector copy = segment.copy(iota(20));
+    int_vector sibling(copy);
+    expect_iota(sibling, 20);
+  }
+  int_vector reused = segment.copy(iota(20));
+  expect_iota(reused, 20);
+}
+
+TEST(shm_segment, released_buffer_drops_mapping) {
+  size_t before = segment_mappings();
+  int_vector::released_buffer buffer;
+  {
+    socow_shm_segment segment = socow_shm_segment::create(1 << 16);
+    buffer = segment.copy(iota(30)).release();
+  }
+  EXPECT_EQ(segment_mappings(), before + 1);
+  ASSERT_EQ(buffer.size, 30u);
+  for (size_t i = 0; i < buffer.size; ++i) {
+    EXPECT_EQ(buffer.data[i], static_cast<int>(i));
+  }
+  buffer.deallocate(buffer.context, buffer.size);
+  EXPECT_EQ(segment_mappings(), before);
+}
+
+TEST(shm_segment, handle_past_the_end_is_rejected) {
+  socow_shm_segment segment = socow_shm_segment::create(1 << 16);
+  EXPECT_THROW((segment.adopt<int, 2>({(1 << 16) - 8, 1})), std::out_of_range);
+  EXPECT_THROW((segment.adopt<int, 2>({1 << 16, 1})), std::out_of_range);
+  EXPECT_THROW((segment.adopt<int, 2>({SIZE_MAX, 1})), std::out_of_range);
+}
+
+} // namespace
+} // namespace socow_test
@@ -0,0 +1,74 @@
+#include "socow-vector.h"
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <utility>
+
+namespace socow_test {
+namespace {
+
+using int_vector = socow_vector<int, 2>;
+
+int_vector iota(size_t size) {
+  int_vector result;
+  for (size_t i = 0; i < size; ++i) {
+    result.push_back(static_cast<int>(i));
+  }
+  return result;
+}
+
+TEST(storage_token, stable_without_mutable_access) {
+  int_vector v = iota(16);
+  socow_storage_token token = v.storage_token();
+  EXPECT_EQ(std::as_const(v)[3], 3);
+  EXPECT_EQ(token, v.storage_token());
+  int_vector copy(v);
+  EXPECT_EQ(token, copy.storage_token());
+}
+
+TEST(storage_token, reference_handed_out_after_token) {
+  int_vector v = iota(16);
+  socow_storage_token token = v.storage_token();
+  int& element = v[3];
+  element = 42;
+  EXPECT_NE(token, v.storage_token());
+}
+
+TEST(storage_token, iterator_handed_out_after_token) {
+  int_vector v = iota(16);
+  socow_storage_token token = v.storage_token();
+  int_vector::iterator it = v.begin() + 3;
+  *it = 42;
+  EXPECT_NE(token, v.storage_token());
+}
+
+TEST(storage_token, held_reference_write_requires_fresh_access) {
+  int_vector v = iota(16);
+  int& element = v[3];
+  socow_storage_token token = v.storage_token();
+  element = 42;
+  v.data();
+  EXPECT_NE(token, v.storage_token());
+}
+
+TEST(storage_token, held_iterator_write_requires_fresh_access) {
+  int_vector v = iota(16);
+  int_vector::iterator it = v.begin() + 3;
+  socow_storage_token token = v.storage_token();
+  *it = 42;
+  v.begin();
+  EXPECT_NE(token, v.storage_token());
+}
+
+TEST(storage_token, detached_copy_gets_new_token) {
+  int_vector v = iota(16);
+  int_vector copy(v);
+  socow_storage_token token = copy.storage_token();
+  copy[0] = 42;
+  EXPECT_NE(token, copy.storage_token());
+  EXPECT_EQ(token, v.storage_token());
+}
+
+} // namespace
+} // namespace socow_test
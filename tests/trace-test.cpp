@@ -0,0 +1,71 @@
+#include "socow-vector.h"
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+static_assert(SOCOW_VECTOR_TRACE_DETACHES, "this test checks detach tracing");
+
+namespace socow_test {
+namespace {
+
+using int_vector = socow_vector<int, 2>;
+
+int_vector iota(size_t size) {
+  int_vector result;
+  for (size_t i = 0; i < size; ++i) {
+    result.push_back(static_cast<int>(i));
+  }
+  return result;
+}
+
+void expect_single_site(uint32_t line) {
+  std::vector<socow_trace::site_report> report = socow_trace::detach_report();
+  ASSERT_EQ(report.size(), 1u);
+  EXPECT_EQ(report[0].file, std::string_view(__FILE__));
+  EXPECT_EQ(report[0].line, line);
+  EXPECT_EQ(report[0].detaches, 1u);
+}
+
+TEST(trace, index_write_is_attributed_to_caller) {
+  socow_trace::reset_detach_report();
+  int_vector original = iota(16);
+  int_vector copy = original;
+  uint32_t line = __LINE__ + 1;
+  copy[3] = 42;
+  expect_single_site(line);
+}
+
+TEST(trace, proxy_write_is_attributed_to_iterator_creation) {
+  socow_trace::reset_detach_report();
+  int_vector original = iota(16);
+  int_vector copy = original;
+  uint32_t line = __LINE__ + 1;
+  int_vector::cow_iterator it = copy.cow_begin();
+  EXPECT_EQ(it[5], 5);
+  EXPECT_EQ(socow_trace::detach_report().size(), 0u);
+  it[5] = 42;
+  expect_single_site(line);
+  EXPECT_EQ(std::as_const(copy)[5], 42);
+  EXPECT_EQ(std::as_const(original)[5], 5);
+}
+
+TEST(trace, proxy_write_through_view_is_attributed_to_loop) {
+  socow_trace::reset_detach_report();
+  int_vector original = iota(16);
+  int_vector copy = original;
+  uint32_t line = __LINE__ + 1;
+  for (auto element : copy.cow_elements()) {
+    if (element == 7) {
+      element = 70;
+    }
+  }
+  expect_single_site(line);
+  EXPECT_EQ(std::as_const(copy)[7], 70);
+}
+
+} // namespace
+} // namespace socow_test